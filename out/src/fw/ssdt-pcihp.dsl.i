@@ -0,0 +1,35 @@
+
+/* ACPI_EXTRACT_ALL_CODE ssdp_pcihp_aml */
+
+DefinitionBlock ("ssdt-pcihp.aml", "SSDT", 0x01, "BXPC", "BXSSDTPCIHP", 0x1)
+{
+    External(\_SB.PCI0, DeviceObj)
+    External(\_SB.PCI0.PCEJ, MethodObj)
+    Scope(\_SB.PCI0) {
+        
+/* ACPI_EXTRACT_DEVICE_START ssdt_pcihp_start */
+
+        
+/* ACPI_EXTRACT_DEVICE_END ssdt_pcihp_end */
+
+        
+/* ACPI_EXTRACT_DEVICE_STRING ssdt_pcihp_name */
+
+        Device(SAA) {
+            
+/* ACPI_EXTRACT_NAME_BYTE_CONST ssdt_pcihp_id */
+
+            Name(_SUN, 0xAA)
+            
+/* ACPI_EXTRACT_NAME_DWORD_CONST ssdt_pcihp_adr */
+
+            Name(_ADR, 0xAA0000)
+            
+/* ACPI_EXTRACT_METHOD_STRING ssdt_pcihp_ej0 */
+
+            Method(_EJ0, 1) {
+                Return (PCEJ(_SUN))
+            }
+        }
+    }
+}
@@ -0,0 +1,254 @@
+#!/usr/bin/env python
+# Script that boots a SeaBIOS build in QEMU and reports POST timings.
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+
+# Usage:
+#   scripts/bootbench.py [-q qemu-system-x86_64] [-n runs] [out/bios.bin]
+#
+# The build should have CONFIG_DEBUG_TIMELINE enabled - the POST
+# timeline shown before the int19 jump is read from the debug port.
+# Without it only the host side time to int19 is reported.
+
+import sys
+import os
+import re
+import time
+import json
+import shutil
+import tempfile
+import subprocess
+import optparse
+
+# Disk image size used for the generated (empty) drives.
+DISKSIZE = 64 * 1024 * 1024
+
+# Reference configurations: name -> (qemu arguments, number of disks).
+# A "%(diskN)s" entry is replaced with the path to the Nth disk image.
+CONFIGS = [
+    ("virtio-blk", ["-drive", "file=%(disk0)s,if=virtio,format=raw"], 1),
+    ("ahci", ["-M", "q35",
+              "-drive", "file=%(disk0)s,if=none,id=d0,format=raw",
+              "-device", "ide-hd,drive=d0,bus=ide.0"], 1),
+    ("usb-msc", ["-device", "usb-ehci,id=ehci",
+                 "-drive", "file=%(disk0)s,if=none,id=u0,format=raw",
+                 "-device", "usb-storage,bus=ehci.0,drive=u0"], 1),
+    ("many-cpu", ["-smp", "64",
+                  "-drive", "file=%(disk0)s,if=virtio,format=raw"], 1),
+    ("many-disk", [], 8),
+    ("kernel", [], 0),
+]
+
+# Debug port messages marking the end of POST.
+BOOTMARKS = [") startBoot\n", "Jump to int19", "Booting from "]
+
+RE_TIMELINE = re.compile(r'^  (\d+) \(\+\d+\) (.*)$')
+RE_THREAD = re.compile(r'^thread ([0-9a-f]{8})( .*)$')
+
+
+######################################################################
+# Running QEMU
+######################################################################
+
+def buildargs(options, name, args, diskcount, tmpdir):
+    disks = {}
+    for i in range(diskcount):
+        path = os.path.join(tmpdir, "disk%d.img" % (i,))
+        f = open(path, 'wb')
+        f.truncate(DISKSIZE)
+        f.close()
+        disks["disk%d" % (i,)] = path
+    args = [a % disks for a in args]
+    if name == "many-disk":
+        for i in range(diskcount):
+            args += ["-drive", "file=%s,if=virtio,format=raw" % (
+                disks["disk%d" % (i,)],)]
+    elif name == "kernel":
+        args += ["-kernel", options.kernel]
+        if options.initrd:
+            args += ["-initrd", options.initrd]
+    return args
+
+def runqemu(options, args, logname):
+    cmd = [options.qemu, "-bios", options.bios, "-m", str(options.mem)
+           , "-display", "none", "-nodefaults", "-serial", "none"
+           , "-chardev", "file,id=seabios,path=%s" % (logname,)
+           , "-device", "isa-debugcon,iobase=0x402,chardev=seabios"]
+    if options.kvm:
+        cmd += ["-enable-kvm"]
+    cmd += args
+    devnull = open(os.devnull, 'wb')
+    starttime = time.time()
+    proc = subprocess.Popen(cmd, stdout=devnull, stderr=devnull)
+    endtime = None
+    try:
+        while time.time() - starttime < options.timeout:
+            if proc.poll() is not None:
+                break
+            time.sleep(0.01)
+            data = open(logname, 'rb').read().decode('latin-1')
+            if [m for m in BOOTMARKS if m in data]:
+                endtime = time.time()
+                break
+    finally:
+        if proc.poll() is None:
+            proc.kill()
+        proc.wait()
+        devnull.close()
+    data = open(logname, 'rb').read().decode('latin-1')
+    return data, endtime and endtime - starttime
+
+
+######################################################################
+# Log parsing
+######################################################################
+
+# Extract the POST timeline - returns [(usec, name), ...]
+def parsetimeline(data):
+    out = []
+    intimeline = 0
+    for line in data.split('\n'):
+        if line.startswith("POST timeline"):
+            intimeline = 1
+            out = []
+            continue
+        if not intimeline:
+            continue
+        m = RE_TIMELINE.match(line)
+        if m is None:
+            intimeline = 0
+            continue
+        out.append((int(m.group(1)), m.group(2)))
+    return out
+
+# Thread events are labeled with the (per run) thread stack address -
+# key them on the thread function instead, so that runs can be compared.
+def normalizenames(timeline):
+    threadfuncs = {}
+    out = []
+    for usec, name in timeline:
+        m = RE_THREAD.match(name)
+        if m is not None:
+            thread, rest = m.groups()
+            if rest == " done":
+                rest = threadfuncs.get(thread, " ?") + rest
+            else:
+                threadfuncs[thread] = rest
+            name = "thread" + rest
+        out.append((usec, name))
+    return out
+
+# Convert a timeline to per event durations (until the next event).
+def phasetimes(timeline):
+    phases = {}
+    timeline = normalizenames(timeline)
+    for i in range(len(timeline) - 1):
+        usec, name = timeline[i]
+        phases[name] = phases.get(name, 0) + timeline[i+1][0] - usec
+    return phases
+
+def median(values):
+    values = sorted(values)
+    if not values:
+        return None
+    return values[len(values) // 2]
+
+def runconfig(options, name, args, diskcount):
+    tmpdir = tempfile.mkdtemp(prefix="bootbench-")
+    try:
+        args = buildargs(options, name, args, diskcount, tmpdir)
+        runs = []
+        for i in range(options.runs):
+            logname = os.path.join(tmpdir, "debug%d.log" % (i,))
+            data, hosttime = runqemu(options, args, logname)
+            timeline = parsetimeline(data)
+            run = {"host_time_to_int19_us": None, "time_to_int19_us": None
+                   , "phases": phasetimes(timeline)}
+            if hosttime is not None:
+                run["host_time_to_int19_us"] = int(hosttime * 1000000)
+            for usec, ename in timeline:
+                if ename == "startBoot":
+                    run["time_to_int19_us"] = usec
+            if options.keeplogs:
+                shutil.copy(logname, "bootbench-%s-%d.log" % (name, i))
+            runs.append(run)
+    finally:
+        shutil.rmtree(tmpdir)
+    names = set()
+    for run in runs:
+        names.update(run["phases"].keys())
+    summary = {
+        "runs": runs,
+        "time_to_int19_us": median([r["time_to_int19_us"] for r in runs
+                                    if r["time_to_int19_us"] is not None]),
+        "host_time_to_int19_us": median(
+            [r["host_time_to_int19_us"] for r in runs
+             if r["host_time_to_int19_us"] is not None]),
+        "phases": dict([(n, median([r["phases"][n] for r in runs
+                                    if n in r["phases"]]))
+                        for n in names]),
+    }
+    return summary
+
+
+######################################################################
+# Startup
+######################################################################
+
+def main():
+    usage = "%prog [options] [<bios.bin>]"
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-q", "--qemu", dest="qemu",
+                    default="qemu-system-x86_64",
+                    help="QEMU binary to run")
+    opts.add_option("-n", "--runs", type="int", dest="runs", default=5,
+                    help="number of boots per configuration")
+    opts.add_option("-c", "--config", action="append", dest="configs",
+                    help="run only this configuration (may be repeated)")
+    opts.add_option("-k", "--kernel", dest="kernel", default=None,
+                    help="kernel for the direct kernel boot configuration")
+    opts.add_option("-i", "--initrd", dest="initrd", default=None,
+                    help="initrd for the direct kernel boot configuration")
+    opts.add_option("-m", "--mem", type="int", dest="mem", default=512,
+                    help="guest memory size (in MB)")
+    opts.add_option("-t", "--timeout", type="float", dest="timeout",
+                    default=60.0, help="seconds to wait for each boot")
+    opts.add_option("-o", "--output", dest="output", default=None,
+                    help="write the results to this file")
+    opts.add_option("--kvm", action="store_true", dest="kvm", default=False,
+                    help="run QEMU with KVM acceleration")
+    opts.add_option("--keep-logs", action="store_true", dest="keeplogs",
+                    default=False, help="keep the debug port logs")
+    options, args = opts.parse_args()
+    if len(args) > 1:
+        opts.error("Too many arguments")
+    options.bios = "out/bios.bin"
+    if args:
+        options.bios = args[0]
+    if not os.path.exists(options.bios):
+        opts.error("Unable to find %s" % (options.bios,))
+
+    configs = CONFIGS
+    if options.configs:
+        configs = [c for c in CONFIGS if c[0] in options.configs]
+        unknown = set(options.configs) - set([c[0] for c in configs])
+        if unknown:
+            opts.error("Unknown configuration %s" % (", ".join(unknown),))
+    if options.kernel is None:
+        configs = [c for c in configs if c[0] != "kernel"]
+
+    results = {"bios": options.bios, "qemu": options.qemu, "configs": {}}
+    for name, args, diskcount in configs:
+        sys.stderr.write("Running %s...\n" % (name,))
+        results["configs"][name] = runconfig(options, name, args, diskcount)
+
+    out = json.dumps(results, indent=2, sort_keys=True)
+    if options.output:
+        f = open(options.output, 'w')
+        f.write(out + "\n")
+        f.close()
+    else:
+        sys.stdout.write(out + "\n")
+
+if __name__ == '__main__':
+    main()
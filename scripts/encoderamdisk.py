@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+# Encode a floppy image as a chunked lzma ramdisk ("floppyimg/*.clzma").
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+
+import sys
+import struct
+import lzma
+
+MAGIC = 0x5a4c4453
+DEFAULT_CHUNKSIZE = 64 * 1024
+
+def compresschunk(data):
+    # The firmware decoder needs the uncompressed size in the header.
+    out = lzma.compress(data, format=lzma.FORMAT_ALONE)
+    return out[:5] + struct.pack('<Q', len(data)) + out[13:]
+
+def main():
+    infile = sys.argv[1]
+    outfile = sys.argv[2]
+    chunksize = DEFAULT_CHUNKSIZE
+    if len(sys.argv) > 3:
+        chunksize = int(sys.argv[3])
+    if not chunksize or chunksize % 512:
+        sys.stderr.write("Chunk size must be a multiple of 512\n")
+        sys.exit(1)
+
+    f = open(infile, 'rb')
+    image = f.read()
+    f.close()
+
+    chunks = [compresschunk(image[i:i+chunksize])
+              for i in range(0, len(image), chunksize)]
+    pos = 16 + 4 * (len(chunks) + 1)
+    offsets = []
+    for c in chunks:
+        offsets.append(pos)
+        pos += len(c)
+    offsets.append(pos)
+
+    f = open(outfile, 'wb')
+    f.write(struct.pack('<IIII', MAGIC, len(image), chunksize, len(chunks)))
+    f.write(struct.pack('<%dI' % len(offsets), *offsets))
+    for c in chunks:
+        f.write(c)
+    f.close()
+
+if __name__ == '__main__':
+    main()
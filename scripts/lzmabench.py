@@ -0,0 +1,239 @@
+#!/usr/bin/env python
+# Script that times the lzma decoder against an older version on the host.
+#
+# This file may be distributed under the terms of the GNU GPLv3 license.
+
+# Usage:
+#   scripts/lzmabench.py [-r revision] [-n runs] <coreboot.rom|file.lzma>...
+#
+# Every lzma stream found in the given files (CBFS "*.lzma" files and
+# lzma compressed payload segments of a coreboot rom, or plain lzma
+# files as stored in CBFS) is decoded with a host build of
+# src/fw/lzmadecode.c from the working tree and with the version from
+# the given git revision.  The revision defaults to the one before the
+# last change to the decoder.
+
+import sys
+import os
+import struct
+import tempfile
+import shutil
+import subprocess
+import optparse
+
+DECODER = "src/fw/lzmadecode.c"
+DECODERH = "src/fw/lzmadecode.h"
+LZMA_PROPERTIES_SIZE = 5
+
+# Host program that decodes a stream several times and reports a hash of
+# the output followed by the time of each run (in nanoseconds).
+DRIVER = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lzmadecode.h"
+
+int main(int argc, char **argv)
+{
+    FILE *f = fopen(argv[1], "rb");
+    if (!f)
+        return 1;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *src = malloc(len);
+    if (!src || fread(src, 1, len, f) != len)
+        return 1;
+    fclose(f);
+    int runs = atoi(argv[2]);
+
+    CLzmaDecoderState state;
+    if (LzmaDecodeProperties(&state.Properties, src, LZMA_PROPERTIES_SIZE))
+        return 2;
+    state.Probs = malloc(LzmaGetNumProbs(&state.Properties) * sizeof(CProb));
+    UInt32 dstlen;
+    memcpy(&dstlen, src + LZMA_PROPERTIES_SIZE, sizeof(dstlen));
+    unsigned char *dst = malloc(dstlen);
+    if (!state.Probs || !dst)
+        return 1;
+
+    unsigned long long times[runs];
+    int i;
+    for (i=0; i<runs; i++) {
+        struct timespec start, end;
+        SizeT inProcessed, outProcessed;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int ret = LzmaDecode(&state, src + LZMA_PROPERTIES_SIZE + 8, len
+                             , &inProcessed, dst, dstlen, &outProcessed);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (ret)
+            return 2;
+        times[i] = ((end.tv_sec - start.tv_sec) * 1000000000ULL
+                    + end.tv_nsec - start.tv_nsec);
+    }
+
+    unsigned int hash = 2166136261u;
+    for (i=0; i<dstlen; i++)
+        hash = (hash ^ dst[i]) * 16777619u;
+    printf("%08x", hash);
+    for (i=0; i<runs; i++)
+        printf(" %llu", times[i]);
+    printf("\n");
+    return 0;
+}
+"""
+
+
+######################################################################
+# Finding lzma streams
+######################################################################
+
+CBFS_FILE_MAGIC = b"LARCHIVE"
+CBFS_COMPRESS_LZMA = 1
+PAYLOAD_SEGMENT_ENTRY = 0x52544E45
+PAYLOAD_SEGMENT_BSS = 0x20535342
+
+# Extract the lzma compressed segments of a CBFS payload.
+def payloadstreams(name, data):
+    out = []
+    pos = 0
+    while pos + 28 <= len(data):
+        stype, comp, offset, load, slen, mlen = struct.unpack_from(
+            ">IIIQII", data, pos)
+        pos += 28
+        if stype == PAYLOAD_SEGMENT_ENTRY:
+            break
+        if stype != PAYLOAD_SEGMENT_BSS and comp == CBFS_COMPRESS_LZMA:
+            out.append(("%s@%x" % (name, load), data[offset:offset+slen]))
+    return out
+
+# Find the lzma streams in a CBFS image - returns [(name, data), ...]
+def cbfsstreams(data):
+    out = []
+    pos = data.find(CBFS_FILE_MAGIC)
+    while pos >= 0:
+        flen, ftype, csum, offset = struct.unpack_from(">IIII", data, pos+8)
+        if offset < 24 or pos + offset + flen > len(data):
+            pos = data.find(CBFS_FILE_MAGIC, pos+1)
+            continue
+        name = data[pos+24:pos+offset].split(b'\0')[0].decode('latin-1')
+        fdata = data[pos+offset:pos+offset+flen]
+        if name.endswith(".lzma"):
+            out.append((name, fdata))
+        elif name.startswith("img/") or name.startswith("fallback/payload"):
+            out += payloadstreams(name, fdata)
+        pos = data.find(CBFS_FILE_MAGIC, pos+offset+flen)
+    return out
+
+def findstreams(filename):
+    data = open(filename, 'rb').read()
+    if CBFS_FILE_MAGIC in data:
+        return cbfsstreams(data)
+    return [(os.path.basename(filename), data)]
+
+
+######################################################################
+# Building and running the decoders
+######################################################################
+
+def builddecoder(options, tmpdir, name, revision):
+    srcdir = os.path.join(tmpdir, name)
+    os.mkdir(srcdir)
+    for path in [DECODER, DECODERH]:
+        dest = os.path.join(srcdir, os.path.basename(path))
+        if revision is None:
+            shutil.copy(path, dest)
+            continue
+        data = subprocess.check_output(
+            ["git", "show", "%s:%s" % (revision, path)])
+        open(dest, 'wb').write(data)
+    driver = os.path.join(srcdir, "driver.c")
+    open(driver, 'w').write(DRIVER)
+    binary = os.path.join(tmpdir, "lzma-" + name)
+    cmd = ([options.cc] + options.cflags.split()
+           + ["-I", srcdir, "-o", binary, driver
+              , os.path.join(srcdir, "lzmadecode.c")])
+    subprocess.check_call(cmd)
+    return binary
+
+def rundecoder(options, binary, filename):
+    proc = subprocess.Popen([binary, filename, str(options.runs)]
+                            , stdout=subprocess.PIPE)
+    out = proc.communicate()[0]
+    if proc.returncode:
+        return None, None
+    fields = out.decode().split()
+    times = sorted([int(t) for t in fields[1:]])
+    return fields[0], times[len(times) // 2]
+
+def lastrevision():
+    revs = subprocess.check_output(
+        ["git", "log", "-n", "2", "--format=%H", "--", DECODER])
+    revs = revs.decode().split()
+    if len(revs) < 2:
+        return revs[0]
+    return revs[1]
+
+
+######################################################################
+# Startup
+######################################################################
+
+def main():
+    usage = "%prog [options] <coreboot.rom|file.lzma>..."
+    opts = optparse.OptionParser(usage)
+    opts.add_option("-r", "--revision", dest="revision", default=None,
+                    help="git revision of the decoder to compare against")
+    opts.add_option("-n", "--runs", type="int", dest="runs", default=9,
+                    help="number of decodes per stream")
+    opts.add_option("--cc", dest="cc", default="gcc",
+                    help="host compiler")
+    opts.add_option("--cflags", dest="cflags", default="-Os",
+                    help="host compiler flags (the firmware is built with"
+                    " '-Os -m32')")
+    options, args = opts.parse_args()
+    if not args:
+        opts.error("No input files")
+    revision = options.revision or lastrevision()
+
+    streams = []
+    for filename in args:
+        streams += findstreams(filename)
+    if not streams:
+        sys.stderr.write("No lzma streams found\n")
+        sys.exit(1)
+
+    tmpdir = tempfile.mkdtemp(prefix="lzmabench-")
+    try:
+        oldbin = builddecoder(options, tmpdir, "old", revision)
+        newbin = builddecoder(options, tmpdir, "new", None)
+        sys.stdout.write("Comparing with %s (%s runs each)\n" % (
+            revision, options.runs))
+        sys.stdout.write("%-40s %9s %9s %7s\n" % (
+            "stream", "old us", "new us", "change"))
+        totalold = totalnew = 0
+        for name, data in streams:
+            filename = os.path.join(tmpdir, "stream.lzma")
+            open(filename, 'wb').write(data)
+            oldhash, oldtime = rundecoder(options, oldbin, filename)
+            newhash, newtime = rundecoder(options, newbin, filename)
+            if oldhash is None:
+                sys.stdout.write("%-40s (can't decode - skipped)\n" % (name,))
+                continue
+            if oldhash != newhash:
+                sys.stderr.write("Output of %s differs\n" % (name,))
+                sys.exit(1)
+            totalold += oldtime
+            totalnew += newtime
+            sys.stdout.write("%-40s %9d %9d %+6.1f%%\n" % (
+                name, oldtime // 1000, newtime // 1000
+                , (newtime - oldtime) * 100.0 / oldtime))
+        sys.stdout.write("%-40s %9d %9d %+6.1f%%\n" % (
+            "total", totalold // 1000, totalnew // 1000
+            , (totalnew - totalold) * 100.0 / totalold))
+    finally:
+        shutil.rmtree(tmpdir)
+
+if __name__ == '__main__':
+    main()
@@ -22,8 +22,57 @@
  * Boot priority ordering
  ****************************************************************/
 
-static char **Bootorder VARVERIFY32INIT;
-static int BootorderCount;
+// The bootorder file is compiled into a trie of its lines, so that a
+// lookup is a single walk that only branches at '*' glob characters.
+struct bootorder_node_s {
+    struct bootorder_node_s *child, *sibling;
+    int prio;           // Number of the line ending at this node (or 0)
+    int minprio;        // Lowest line number in this subtree
+    char c;
+};
+static struct bootorder_node_s *BootorderTrie VARVERIFY32INIT;
+static int BootFirstReady;
+
+// The nodes are handed out from one allocation sized from the file
+// (each character of the file adds at most one node).
+static struct bootorder_node_s *BootorderPool VARVERIFY32INIT;
+static int BootorderPoolFree VARVERIFY32INIT;
+
+static struct bootorder_node_s *
+bootorder_newnode(char c, int prio)
+{
+    if (!BootorderPoolFree)
+        return NULL;
+    struct bootorder_node_s *n = BootorderPool++;
+    BootorderPoolFree--;
+    memset(n, 0, sizeof(*n));
+    n->c = c;
+    n->minprio = prio;
+    return n;
+}
+
+static int
+bootorder_add(const char *line, int prio)
+{
+    struct bootorder_node_s *node = BootorderTrie;
+    for (; *line; line++) {
+        struct bootorder_node_s *n;
+        for (n = node->child; n; n = n->sibling)
+            if (n->c == *line)
+                break;
+        if (!n) {
+            n = bootorder_newnode(*line, prio);
+            if (!n)
+                return -1;
+            n->sibling = node->child;
+            node->child = n;
+        }
+        node = n;
+    }
+    if (!node->prio)
+        node->prio = prio;
+    return 0;
+}
 
 static void
 loadBootOrder(void)
@@ -31,71 +80,104 @@ loadBootOrder(void)
     if (!CONFIG_BOOTORDER)
         return;
 
-    char *f = romfile_loadfile("bootorder", NULL);
-    if (!f)
+    int filesize;
+    char *file = romfile_loadfile("bootorder", &filesize);
+    if (!file)
         return;
 
-    int i = 0;
-    BootorderCount = 1;
-    while (f[i]) {
-        if (f[i] == '\n')
-            BootorderCount++;
-        i++;
-    }
-    Bootorder = malloc_tmphigh(BootorderCount*sizeof(char*));
-    if (!Bootorder) {
+    BootorderPool = malloc_tmphigh((filesize + 1) * sizeof(BootorderPool[0]));
+    if (!BootorderPool) {
         warn_noalloc();
-        free(f);
-        BootorderCount = 0;
+        free(file);
         return;
     }
+    BootorderPoolFree = filesize + 1;
+    BootorderTrie = bootorder_newnode(0, 1);
 
     dprintf(3, "boot order:\n");
-    i = 0;
+    char *f = file;
+    int i = 0;
     do {
-        Bootorder[i] = f;
+        char *line = f;
         f = strchr(f, '\n');
         if (f)
             *(f++) = '\0';
-        nullTrailingSpace(Bootorder[i]);
-        dprintf(3, "%d: %s\n", i+1, Bootorder[i]);
+        nullTrailingSpace(line);
+        dprintf(3, "%d: %s\n", i+1, line);
+        if (bootorder_add(line, i+1))
+            break;
         i++;
     } while (f);
+    free(file);
 }
 
-// See if 'str' starts with 'glob' - if glob contains an '*' character
-// it will match any number of characters in str that aren't a '/' or
-// the next glob character.
-static char *
-glob_prefix(const char *glob, const char *str)
+// Return the lower of two line numbers (0 meaning no match).
+static int
+prio_min(int a, int b)
 {
-    for (;;) {
-        if (!*glob && (!*str || *str == '/'))
-            return (char*)str;
-        if (*glob == '*') {
-            if (!*str || *str == '/' || *str == glob[1])
-                glob++;
-            else
-                str++;
-            continue;
+    if (!a || (b && b < a))
+        return b;
+    return a;
+}
+
+// Find the lowest numbered line below 'node' that starts with 'glob'.
+// If glob contains an '*' character it will match any number of
+// characters in the line that aren't a '/' or the next glob character.
+// A match must end at the end of the line or before a '/'.
+static int
+bootorder_match(struct bootorder_node_s *node, const char *glob)
+{
+    struct bootorder_node_s *n;
+    while (*glob != '*') {
+        if (!*glob) {
+            // Lines ending here or continuing with a '/' match.
+            int prio = node->prio;
+            for (n = node->child; n; n = n->sibling)
+                if (n->c == '/')
+                    prio = prio_min(prio, n->minprio);
+            return prio;
         }
-        if (*glob != *str)
-            return NULL;
+        for (n = node->child; n; n = n->sibling)
+            if (n->c == *glob)
+                break;
+        if (!n)
+            return 0;
+        node = n;
         glob++;
-        str++;
     }
+
+    // Glob character - branch on the next character of the lines.
+    int prio = 0;
+    if (node->prio) {
+        const char *g = glob;
+        while (*g == '*')
+            g++;
+        if (!*g)
+            prio = node->prio;
+    }
+    for (n = node->child; n; n = n->sibling) {
+        const char *g = glob;
+        while (*g == '*' && (n->c == '/' || n->c == g[1]))
+            g++;
+        if (*g == '*')
+            prio = prio_min(prio, bootorder_match(n, g));
+        else if (!*g)
+            prio = prio_min(prio, n->c == '/' ? n->minprio : 0);
+        else if (*g == n->c)
+            prio = prio_min(prio, bootorder_match(n, g+1));
+    }
+    return prio;
 }
 
 // Search the bootorder list for the given glob pattern.
 static int
 find_prio(const char *glob)
 {
-    dprintf(1, "Searching bootorder for: %s\n", glob);
-    int i;
-    for (i = 0; i < BootorderCount; i++)
-        if (glob_prefix(glob, Bootorder[i]))
-            return i+1;
-    return -1;
+    dprintf(DEBUG_bootorder, "Searching bootorder for: %s\n", glob);
+    if (!BootorderTrie)
+        return -1;
+    int prio = bootorder_match(BootorderTrie, glob);
+    return prio ? prio : -1;
 }
 
 #define FW_PCI_DOMAIN "/pci@i0cf8"
@@ -213,6 +295,19 @@ build_usb_path(char *buf, int max, struct usbhub_s *hub)
     return p;
 }
 
+// Find the first bootorder entry located behind the given usb hub port.
+int bootprio_find_usb_port(struct usbhub_s *hub, int port)
+{
+    if (!CONFIG_BOOTORDER || !BootorderTrie)
+        return -1;
+    // Find usb port - for example: /pci@i0cf8/usb@1,2/hub@1/*@3
+    char desc[256], *p;
+    p = build_pci_path(desc, sizeof(desc), "usb", hub->cntl->pci);
+    p = build_usb_path(p, desc+sizeof(desc)-p, hub);
+    snprintf(p, desc+sizeof(desc)-p, "/*@%x", port+1);
+    return find_prio(desc);
+}
+
 int bootprio_find_usb(struct usbdevice_s *usbdev, int lun)
 {
     if (!CONFIG_BOOTORDER)
@@ -239,6 +334,13 @@ int bootprio_find_usb(struct usbdevice_s *usbdev, int lun)
 static int BootRetryTime;
 static int CheckFloppySig = 1;
 
+// Stop probing devices once the first boot device is ready.
+static int BootFastBoot;
+
+// Boot menu settings (see bootmenu_start).
+static int ShowBootMenu, BootMenuKey, BootMenuStarted;
+static u32 BootMenuEnd;
+
 #define DEFAULT_PRIO           9999
 
 static int DefaultFloppyPrio = 101;
@@ -274,6 +376,14 @@ boot_init(void)
     }
 
     BootRetryTime = romfile_loadint("etc/boot-fail-wait", 60*1000);
+    ShowBootMenu = CONFIG_BOOTMENU && romfile_loadint("etc/show-boot-menu", 1);
+    if (ShowBootMenu) {
+        BootMenuKey = romfile_loadint("etc/boot-menu-key", 0x86);
+        if (romfile_loadint("etc/boot-menu-latch", 0))
+            // Note a press of the menu key at any time during POST.
+            SET_LOW(KeyLatchCode, BootMenuKey);
+    }
+    BootFastBoot = romfile_loadint("etc/boot-fastboot", 0);
 
     loadBootOrder();
 }
@@ -320,6 +430,8 @@ bootentry_add(int type, int prio, u32 data, const char *desc)
     be->description = desc ?: "?";
     dprintf(3, "Registering bootable: %s (type:%d prio:%d data:%x)\n"
             , be->description, type, prio, data);
+    if (prio == 1)
+        BootFirstReady = 1;
 
     // Add entry in sorted order.
     struct hlist_node **pprev;
@@ -333,15 +445,41 @@ bootentry_add(int type, int prio, u32 data, const char *desc)
             break;
         if (be->type > pos->type)
             continue;
-        if (be->type <= IPL_TYPE_CDROM
-            && (be->drive->type < pos->drive->type
-                || (be->drive->type == pos->drive->type
-                    && be->drive->cntl_id < pos->drive->cntl_id)))
+        if (be->type > IPL_TYPE_CDROM)
+            continue;
+        // Drives are registered by parallel threads - order them by
+        // their properties, not by the order they were found in.
+        if (be->drive->type < pos->drive->type)
+            break;
+        if (be->drive->type > pos->drive->type)
+            continue;
+        if (be->drive->cntl_id < pos->drive->cntl_id)
+            break;
+        if (be->drive->cntl_id > pos->drive->cntl_id)
+            continue;
+        if (strcmp(be->description, pos->description) < 0)
             break;
     }
     hlist_add(&be->node, pprev);
 }
 
+// Check if fast boot is enabled and the device named by the first
+// bootorder entry is ready - usb ports and option roms not in the boot
+// order can then be skipped.
+int
+boot_first_ready(void)
+{
+    return BootFastBoot && BootFirstReady;
+}
+
+// Check if the remaining ata/ahci probes and BCVs can be skipped as
+// well - the first boot device is ready and there is no boot menu.
+int
+boot_fast_path(void)
+{
+    return boot_first_ready() && !ShowBootMenu;
+}
+
 // Return the given priority if it's set - defaultprio otherwise.
 static inline int defPrio(int priority, int defaultprio) {
     return (priority < 0) ? defaultprio : priority;
@@ -401,28 +539,60 @@ boot_add_cbfs(void *data, const char *desc, int prio)
 
 #define DEFAULT_BOOTMENU_WAIT 2500
 
-// Show IPL option menu.
+// Show the boot menu prompt and start the menu key window.  This is
+// called before the option roms run, so that the window overlaps them.
 void
-interactive_bootmenu(void)
+bootmenu_start(void)
 {
-    // XXX - show available drives?
-
-    if (! CONFIG_BOOTMENU || !romfile_loadint("etc/show-boot-menu", 1))
+    if (!ShowBootMenu || BootMenuStarted)
         return;
+    BootMenuStarted = 1;
 
+    // Discard keys pressed before the prompt (a latched menu key press
+    // is kept in KeyLatched).
     while (get_keystroke(0) >= 0)
         ;
 
     char *bootmsg = romfile_loadfile("etc/boot-menu-message", NULL);
-    int menukey = romfile_loadint("etc/boot-menu-key", 0x86);
     printf("%s", bootmsg ?: "\nPress F12 for boot menu.\n\n");
     free(bootmsg);
 
     u32 menutime = romfile_loadint("etc/boot-menu-wait", DEFAULT_BOOTMENU_WAIT);
+    BootMenuEnd = irqtimer_calc(menutime);
+}
+
+// Wait for the menu key.  The wait ends once the menu window has passed
+// and all driver threads have completed (or on any other key).
+static int
+bootmenu_wait(void)
+{
+    for (;;) {
+        if (GET_LOW(KeyLatched))
+            return 1;
+        int scan_code = get_keystroke(0);
+        if (scan_code >= 0)
+            return scan_code == BootMenuKey;
+        if (irqtimer_check(BootMenuEnd) && !have_threads())
+            return 0;
+        yield_toirq();
+    }
+}
+
+// Show IPL option menu.
+void
+interactive_bootmenu(void)
+{
+    // XXX - show available drives?
+
+    if (!ShowBootMenu)
+        return;
+
+    bootmenu_start();
     enable_bootsplash();
-    int scan_code = get_keystroke(menutime);
+    int pressed = bootmenu_wait();
     disable_bootsplash();
-    if (scan_code != menukey)
+    SET_LOW(KeyLatchCode, 0);
+    if (!pressed)
         return;
 
     while (get_keystroke(0) >= 0)
@@ -442,6 +612,7 @@ interactive_bootmenu(void)
     }
 
     // Get key press
+    int scan_code;
     for (;;) {
         scan_code = get_keystroke(1000);
         if (scan_code >= 1 && scan_code <= maxmenu+1)
@@ -498,10 +669,15 @@ bcv_prepboot(void)
         bootentry_add(IPL_TYPE_HALT, haltprio, 0, "HALT");
 
     // Map drives and populate BEV list
+    int fastpath = boot_fast_path();
+    if (fastpath)
+        dprintf(1, "Fast boot - only running BCVs of the first boot device\n");
     struct bootentry_s *pos;
     hlist_for_each_entry(pos, &BootList, node) {
         switch (pos->type) {
         case IPL_TYPE_BCV:
+            if (fastpath && pos->priority > 1)
+                break;
             call_bcv(pos->vector.seg, pos->vector.offset);
             add_bev(IPL_TYPE_HARDDISK, 0);
             break;
@@ -0,0 +1,134 @@
+// Call counters and latency histograms for the runtime bios services.
+//
+// This file may be distributed under the terms of the GNU LGPLv3 license.
+
+#include "bregs.h" // struct bregs
+#include "biosvar.h" // GET_GLOBAL
+#include "config.h" // CONFIG_*
+#include "farptr.h" // GET_FLATPTR
+#include "util.h" // dprintf
+
+#define CALLSTATS_SIGNATURE 0x54534253 // SBST
+
+static u8 CallStatsVectors[CALLSTATS_VECTORS] VAR16 = {
+    0x13, 0x15, 0x16, 0x1a
+};
+
+// Counters kept in low memory so they can be updated from 16bit code.
+struct callstats_s {
+    u32 count[CALLSTATS_VECTORS][256];
+    u32 latency[CALLSTATS_VECTORS][CALLSTATS_BUCKETS];
+};
+
+struct callstats_s *CallStats VARFSEG;
+
+// Allocate the counters.
+void
+callstats_setup(void)
+{
+    if (!CONFIG_DEBUG_CALLSTATS)
+        return;
+    struct callstats_s *cs = malloc_low(sizeof(*cs));
+    if (!cs) {
+        warn_noalloc();
+        return;
+    }
+    memset(cs, 0, sizeof(*cs));
+    CallStats = cs;
+}
+
+// Note the start of a bios call.
+u32
+callstats_start(void)
+{
+    if (!CONFIG_DEBUG_CALLSTATS)
+        return 0;
+    return timer_calc(0);
+}
+
+// Count a bios call without recording its latency (for calls that
+// block waiting for the user) - 'func' is the %ah of the request.
+void
+callstats_count(int vector, u8 func)
+{
+    if (!CONFIG_DEBUG_CALLSTATS)
+        return;
+    struct callstats_s *cs = GET_GLOBAL(CallStats);
+    if (!cs)
+        return;
+    u32 *count = &cs->count[vector][func];
+    SET_FLATPTR(*count, GET_FLATPTR(*count) + 1);
+}
+
+// Count a completed bios call and record its latency.  Latency bucket
+// N holds calls that took less than 4^N microseconds (the last bucket
+// holds everything slower).
+void
+callstats_finish(int vector, u8 func, u32 start)
+{
+    if (!CONFIG_DEBUG_CALLSTATS)
+        return;
+    struct callstats_s *cs = GET_GLOBAL(CallStats);
+    if (!cs)
+        return;
+    u32 usec = timer_elapsed_usec(start);
+    int bucket = 0;
+    while (bucket < CALLSTATS_BUCKETS-1 && usec >= (1 << (2*bucket)))
+        bucket++;
+
+    callstats_count(vector, func);
+    u32 *latency = &cs->latency[vector][bucket];
+    SET_FLATPTR(*latency, GET_FLATPTR(*latency) + 1);
+}
+
+// Show the counters on the debug port.
+static void
+callstats_dump(struct callstats_s *cs)
+{
+    int i, j;
+    for (i=0; i<CALLSTATS_VECTORS; i++) {
+        u8 vector = GET_GLOBAL(CallStatsVectors[i]);
+        for (j=0; j<256; j++) {
+            u32 count = GET_FLATPTR(cs->count[i][j]);
+            if (count)
+                dprintf(1, "int %02x/%02x: %u calls\n", vector, j, count);
+        }
+        dprintf(1, "int %02x latency:", vector);
+        for (j=0; j<CALLSTATS_BUCKETS; j++)
+            dprintf(1, " %u", GET_FLATPTR(cs->latency[i][j]));
+        dprintf(1, "\n");
+    }
+}
+
+// Bios call statistics (vendor specific) - %ebx must hold "SBST".
+//   al=0 - return the table in es:di (size in cx, dl vectors, dh buckets)
+//   al=1 - show the counters on the debug port
+//   al=2 - reset the counters
+void
+handle_15d9(struct bregs *regs)
+{
+    struct callstats_s *cs = GET_GLOBAL(CallStats);
+    if (!CONFIG_DEBUG_CALLSTATS || !cs || regs->ebx != CALLSTATS_SIGNATURE) {
+        set_code_unimplemented(regs, RET_EUNSUPPORTED);
+        return;
+    }
+    switch (regs->al) {
+    case 0x00:
+        regs->es = FLATPTR_TO_SEG(cs);
+        regs->di = FLATPTR_TO_OFFSET(cs);
+        regs->cx = sizeof(*cs);
+        regs->dl = CALLSTATS_VECTORS;
+        regs->dh = CALLSTATS_BUCKETS;
+        break;
+    case 0x01:
+        callstats_dump(cs);
+        break;
+    case 0x02:
+        memset_fl(cs, 0, sizeof(*cs));
+        break;
+    default:
+        set_code_invalid(regs, RET_EUNSUPPORTED);
+        return;
+    }
+    set_code_success(regs);
+}
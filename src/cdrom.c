@@ -9,6 +9,7 @@
 #include "util.h" // memset
 #include "bregs.h" // struct bregs
 #include "biosvar.h" // GET_GLOBAL
+#include "memmap.h" // add_e820
 #include "hw/ata.h" // ATA_CMD_REQUEST_SENSE
 #include "hw/blockcmd.h" // CDB_CMD_REQUEST_SENSE
 
@@ -23,6 +24,92 @@ u8 CDRom_locks[BUILD_MAX_EXTDRIVE] VARLOW;
 struct cdemu_s CDEmu VARLOW;
 struct drive_s *cdemu_drive_gf VARFSEG;
 
+// Cache of recently read cd blocks (used for partial block reads).
+#define CDEMU_CACHE_BLOCKS 8
+u8 *cdemu_cache_fl VARFSEG;
+u8 cdemu_cache_blocks VARFSEG;
+
+// Copy 'count' 512 byte sectors starting at sector 'ofs' of cd block
+// 'lba' to 'buf_fl'.  On a cache miss the block and the blocks that
+// follow it are read ahead into the cache.
+static int
+cdemu_read_cached(struct disk_op_s *dop, u32 lba, int ofs, int count
+                  , void *buf_fl)
+{
+    u8 *cache_fl = GET_GLOBAL(cdemu_cache_fl);
+    u8 blocks = CONFIG_CDROM_EMU_CACHE ? GET_GLOBAL(cdemu_cache_blocks) : 0;
+    u32 cache_lba = GET_LOW(CDEmu.cache_lba);
+    if (!blocks) {
+        // No cache - read the block into the shared bounce buffer.
+        cache_fl = GET_GLOBAL(bounce_buf_fl);
+        blocks = 1;
+        cache_lba = lba;
+        dop->lba = lba;
+        dop->count = 1;
+        dop->buf_fl = cache_fl;
+        int ret = process_op(dop);
+        if (ret)
+            return ret;
+    } else if (lba < cache_lba
+               || lba >= cache_lba + GET_LOW(CDEmu.cache_count)) {
+        // Cache miss - read ahead (retry without read ahead on error,
+        // as the read ahead may run past the end of the disc).
+        SET_LOW(CDEmu.cache_count, 0);
+        dop->lba = lba;
+        dop->count = blocks;
+        dop->buf_fl = cache_fl;
+        int ret = process_op(dop);
+        if (ret) {
+            dop->count = 1;
+            ret = process_op(dop);
+            if (ret)
+                return ret;
+        }
+        cache_lba = lba;
+        SET_LOW(CDEmu.cache_lba, lba);
+        SET_LOW(CDEmu.cache_count, dop->count);
+    }
+    memcpy_fl(buf_fl, cache_fl + (lba - cache_lba) * CDROM_SECTOR_SIZE
+              + ofs * DISK_SECTOR_SIZE, count * DISK_SECTOR_SIZE);
+    return 0;
+}
+
+// Drop the cached and preloaded data of the emulated drive (on
+// emulation stop or when the cdrom media is changed).
+void
+cdemu_invalidate(void)
+{
+    SET_LOW(CDEmu.cache_count, 0);
+    SET_LOW(CDEmu.preload_sectors, 0);
+}
+
+// Buffer for preloading a whole emulated floppy image.
+#define CDEMU_PRELOAD_SIZE (2880 * 1024)
+u8 *cdemu_preload_fl VARFSEG;
+
+// Copy sectors out of the preloaded image.
+int VISIBLE32FLAT
+cdemu_copy_preload(struct disk_op_s *op)
+{
+    memcpy(op->buf_fl, cdemu_preload_fl + (u32)op->lba * DISK_SECTOR_SIZE
+           , op->count * DISK_SECTOR_SIZE);
+    return 0;
+}
+
+static int
+cdemu_read_preload(struct disk_op_s *op)
+{
+    u32 sectors = GET_LOW(CDEmu.preload_sectors);
+    if (!sectors || op->lba + op->count > sectors)
+        return -1;
+    if (MODESEGMENT) {
+        extern void _cfunc32flat_cdemu_copy_preload(struct disk_op_s *op);
+        return call32(_cfunc32flat_cdemu_copy_preload
+                      , (u32)MAKE_FLATPTR(GET_SEG(SS), op), -1);
+    }
+    return cdemu_copy_preload(op);
+}
+
 static int
 cdemu_read(struct disk_op_s *op)
 {
@@ -31,31 +118,29 @@ cdemu_read(struct disk_op_s *op)
     struct disk_op_s dop;
     dop.drive_g = drive_g;
     dop.command = op->command;
-    dop.lba = GET_LOW(CDEmu.ilba) + op->lba / 4;
+    u32 lba = GET_LOW(CDEmu.ilba) + op->lba / 4;
 
     int count = op->count;
     op->count = 0;
-    u8 *cdbuf_fl = GET_GLOBAL(bounce_buf_fl);
 
     if (op->lba & 3) {
         // Partial read of first block.
-        dop.count = 1;
-        dop.buf_fl = cdbuf_fl;
-        int ret = process_op(&dop);
-        if (ret)
-            return ret;
         u8 thiscount = 4 - (op->lba & 3);
         if (thiscount > count)
             thiscount = count;
+        int ret = cdemu_read_cached(&dop, lba, op->lba & 3, thiscount
+                                    , op->buf_fl);
+        if (ret)
+            return ret;
         count -= thiscount;
-        memcpy_fl(op->buf_fl, cdbuf_fl + (op->lba & 3) * 512, thiscount * 512);
         op->buf_fl += thiscount * 512;
         op->count += thiscount;
-        dop.lba++;
+        lba++;
     }
 
     if (count > 3) {
         // Read n number of regular blocks.
+        dop.lba = lba;
         dop.count = count / 4;
         dop.buf_fl = op->buf_fl;
         int ret = process_op(&dop);
@@ -65,19 +150,15 @@ cdemu_read(struct disk_op_s *op)
         u8 thiscount = count & ~3;
         count &= 3;
         op->buf_fl += thiscount * 512;
-        dop.lba += thiscount / 4;
+        lba += thiscount / 4;
     }
 
     if (count) {
         // Partial read on last block.
-        dop.count = 1;
-        dop.buf_fl = cdbuf_fl;
-        int ret = process_op(&dop);
+        int ret = cdemu_read_cached(&dop, lba, 0, count, op->buf_fl);
         if (ret)
             return ret;
-        u8 thiscount = count;
-        memcpy_fl(op->buf_fl, cdbuf_fl, thiscount * 512);
-        op->count += thiscount;
+        op->count += count;
     }
 
     return DISK_RET_SUCCESS;
@@ -91,6 +172,8 @@ process_cdemu_op(struct disk_op_s *op)
 
     switch (op->command) {
     case CMD_READ:
+        if (CONFIG_CDROM_EMU_PRELOAD && !cdemu_read_preload(op))
+            return DISK_RET_SUCCESS;
         return cdemu_read(op);
     case CMD_WRITE:
     case CMD_FORMAT:
@@ -127,6 +210,26 @@ cdrom_prepboot(void)
     drive_g->type = DTYPE_CDEMU;
     drive_g->blksize = DISK_SECTOR_SIZE;
     drive_g->sectors = (u64)-1;
+
+    if (CONFIG_CDROM_EMU_CACHE) {
+        // Allocate the block cache (falls back to the bounce buffer).
+        u8 *cache = malloc_low(CDEMU_CACHE_BLOCKS * CDROM_SECTOR_SIZE);
+        if (cache) {
+            cdemu_cache_fl = cache;
+            cdemu_cache_blocks = CDEMU_CACHE_BLOCKS;
+        }
+    }
+
+    if (CONFIG_CDROM_EMU_PRELOAD) {
+        // Reserve ram to preload an emulated floppy image at boot.
+        u8 *image = memalign_tmphigh(PAGE_SIZE, CDEMU_PRELOAD_SIZE);
+        if (!image) {
+            warn_noalloc();
+            return;
+        }
+        add_e820((u32)image, CDEMU_PRELOAD_SIZE, E820_RESERVED);
+        cdemu_preload_fl = image;
+    }
 }
 
 struct eltorito_s {
@@ -173,6 +276,7 @@ cdemu_134b(struct bregs *regs)
     if (regs->al == 0x00) {
         // FIXME ElTorito Various. Should be handled accordingly to spec
         SET_LOW(CDEmu.active, 0x00); // bye bye
+        cdemu_invalidate();
 
         // XXX - update floppy/hd count.
     }
@@ -255,6 +359,8 @@ cdrom_boot(struct drive_s *drive_g)
 
     lba = *(u32*)&buffer[0x28];
     CDEmu.ilba = lba;
+    CDEmu.cache_count = 0;
+    CDEmu.preload_sectors = 0;
 
     // And we read the image in memory
     dop.lba = lba;
@@ -299,6 +405,20 @@ cdrom_boot(struct drive_s *drive_g)
             CDEmu.lchs.heads = 2;
             break;
         }
+
+        // Read the whole image into ram in one transfer.
+        u32 sectors = (CDEmu.lchs.spt * CDEmu.lchs.cylinders
+                       * CDEmu.lchs.heads);
+        if (CONFIG_CDROM_EMU_PRELOAD && cdemu_preload_fl && sectors) {
+            dop.lba = lba;
+            dop.count = DIV_ROUND_UP(sectors, 4);
+            dop.buf_fl = cdemu_preload_fl;
+            ret = cdb_read(&dop);
+            if (ret)
+                dprintf(1, "Unable to preload emulated image (%d)\n", ret);
+            else
+                CDEmu.preload_sectors = sectors;
+        }
     } else {
         // Harddrive emulation
         CDEmu.emulated_extdrive = 0x80;
@@ -306,6 +306,8 @@ void VISIBLE16
 handle_1a(struct bregs *regs)
 {
     debug_enter(regs, DEBUG_HDL_1a);
+    u8 func = regs->ah;
+    u32 start = callstats_start();
     switch (regs->ah) {
     case 0x00: handle_1a00(regs); break;
     case 0x01: handle_1a01(regs); break;
@@ -317,6 +319,7 @@ handle_1a(struct bregs *regs)
     case 0x07: handle_1a07(regs); break;
     default:   handle_1aXX(regs); break;
     }
+    callstats_finish(CALLSTATS_1a, func, start);
 }
 
 // INT 08h System Timer ISR Entry Point
@@ -103,5 +103,13 @@
 #define DEBUG_unimplemented 2
 #define DEBUG_invalid 3
 #define DEBUG_thread 2
+#define DEBUG_bootorder 1
+
+// Highest debug level kept in the boot log (see CONFIG_DEBUG_LOG_LEVEL)
+#if CONFIG_DEBUG_LOG
+#define DEBUG_LOG_LEVEL CONFIG_DEBUG_LOG_LEVEL
+#else
+#define DEBUG_LOG_LEVEL CONFIG_DEBUG_LEVEL
+#endif
 
 #endif // config.h
@@ -492,6 +492,10 @@ disk_1346(struct bregs *regs, struct drive_s *drive_g)
         disk_ret(regs, DISK_RET_ELOCKED);
         return;
     }
+    if (CONFIG_CDROM_EMU
+        && GLOBALFLAT2GLOBAL(GET_LOW(CDEmu.emulated_drive_gf)) == drive_g)
+        // The media of the emulated drive is gone.
+        cdemu_invalidate();
     disk_ret(regs, DISK_RET_SUCCESS);
 }
 
@@ -849,11 +853,9 @@ handle_40(struct bregs *regs)
     handle_legacy_disk(regs, regs->dl);
 }
 
-// INT 13h Fixed Disk Services Entry Point
-void VISIBLE16
-handle_13(struct bregs *regs)
+static void
+disk_13_dispatch(struct bregs *regs)
 {
-    debug_enter(regs, DEBUG_HDL_13);
     u8 extdrive = regs->dl;
 
     if (CONFIG_CDROM_EMU) {
@@ -883,6 +885,17 @@ handle_13(struct bregs *regs)
     handle_legacy_disk(regs, extdrive);
 }
 
+// INT 13h Fixed Disk Services Entry Point
+void VISIBLE16
+handle_13(struct bregs *regs)
+{
+    debug_enter(regs, DEBUG_HDL_13);
+    u8 func = regs->ah;
+    u32 start = callstats_start();
+    disk_13_dispatch(regs);
+    callstats_finish(CALLSTATS_13, func, start);
+}
+
 // record completion in BIOS task complete flag
 void VISIBLE16
 handle_76(void)
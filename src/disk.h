@@ -202,6 +202,13 @@ struct cdemu_s {
 
     // Virtual device
     struct chs_s lchs;
+
+    // Block cache (see cdemu_read)
+    u32 cache_lba;
+    u8  cache_count;
+
+    // Sectors of the image preloaded into ram (0 if not preloaded)
+    u16 preload_sectors;
 };
 
 struct drive_s {
@@ -271,6 +278,8 @@ int create_bounce_buf(void);
 // floppy.c
 extern struct floppy_ext_dbt_s diskette_param_table2;
 void floppy_setup(void);
+void floppy_prepboot(void);
+int init_floppy_drive(struct drive_s *drive_g, int floppyid, int ftype);
 struct drive_s *init_floppy(int floppyid, int ftype);
 int find_floppy_type(u32 size);
 int process_floppy_op(struct disk_op_s *op);
@@ -281,6 +290,7 @@ extern u8 CDRom_locks[];
 extern struct cdemu_s CDEmu;
 extern struct drive_s *cdemu_drive_gf;
 int process_cdemu_op(struct disk_op_s *op);
+void cdemu_invalidate(void);
 void cdrom_prepboot(void);
 void cdemu_134b(struct bregs *regs);
 int cdrom_boot(struct drive_s *drive_g);
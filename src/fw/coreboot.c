@@ -259,9 +259,11 @@ coreboot_platform_setup(void)
  * ulzma
  ****************************************************************/
 
-// Uncompress data in flash to an area of memory.
-static int
-ulzma(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
+// Uncompress data to an area of memory using the given scratch space
+// for the decoder state.
+int
+ulzma_scratch(u8 *dst, u32 maxlen, const u8 *src, u32 srclen
+              , void *scratch, u32 scratchlen)
 {
     dprintf(3, "Uncompressing data %d@%p to %d@%p\n", srclen, src, maxlen, dst);
     CLzmaDecoderState state;
@@ -270,10 +272,9 @@ ulzma(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
         dprintf(1, "LzmaDecodeProperties error - %d\n", ret);
         return -1;
     }
-    u8 scratch[15980];
     int need = (LzmaGetNumProbs(&state.Properties) * sizeof(CProb));
-    if (need > sizeof(scratch)) {
-        dprintf(1, "LzmaDecode need %d have %d\n", need, (unsigned int)sizeof(scratch));
+    if (need > scratchlen) {
+        dprintf(1, "LzmaDecode need %d have %d\n", need, scratchlen);
         return -1;
     }
     state.Probs = (CProb *)scratch;
@@ -293,6 +294,32 @@ ulzma(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
     return dstlen;
 }
 
+static noinline int
+ulzma_stack(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
+{
+    u8 scratch[LZMA_SCRATCH_SIZE];
+    return ulzma_scratch(dst, maxlen, src, srclen, scratch, sizeof(scratch));
+}
+
+// Uncompress data in flash to an area of memory.
+static int
+ulzma(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
+{
+    if (!CONFIG_THREADS || getCurThread() == &MainThread)
+        return ulzma_stack(dst, maxlen, src, srclen);
+
+    // Threads have small stacks - allocate the decoder state.
+    void *scratch = malloc_tmphigh(LZMA_SCRATCH_SIZE);
+    if (!scratch) {
+        warn_noalloc();
+        return -1;
+    }
+    int ret = ulzma_scratch(dst, maxlen, src, srclen
+                            , scratch, LZMA_SCRATCH_SIZE);
+    free(scratch);
+    return ret;
+}
+
 
 /****************************************************************
  * Coreboot flash format
@@ -323,6 +350,10 @@ struct cbfs_file {
     char filename[0];
 } PACKED;
 
+#define CBFS_COMPRESS_NONE  0
+#define CBFS_COMPRESS_LZMA  1
+#define CBFS_COMPRESS_LZ4   2
+
 struct cbfs_romfile_s {
     struct romfile_s file;
     struct cbfs_file *fhdr;
@@ -342,16 +373,14 @@ cbfs_copyfile(struct romfile_s *file, void *dst, u32 maxlen)
     u32 size = cfile->rawsize;
     void *src = cfile->data;
     if (cfile->flags) {
-        // Compressed - copy to temp ram and uncompress it.
-        void *temp = malloc_tmphigh(size);
-        if (!temp) {
-            warn_noalloc();
-            return -1;
-        }
-        iomemcpy(temp, src, size);
-        int ret = ulzma(dst, maxlen, temp, size);
+        // Compressed - uncompress it straight from the flash mapping
+        // (as is done for payload segments).
+        int ret;
+        if (cfile->flags == CBFS_COMPRESS_LZ4)
+            ret = ulz4(dst, maxlen, src, size);
+        else
+            ret = ulzma(dst, maxlen, src, size);
         yield();
-        free(temp);
         return ret;
     }
 
@@ -401,9 +430,21 @@ coreboot_cbfs_init(void)
         int len = strlen(cfile->file.name);
         if (len > 5 && strcmp(&cfile->file.name[len-5], ".lzma") == 0) {
             // Using compression.
-            cfile->flags = 1;
+            cfile->flags = CBFS_COMPRESS_LZMA;
             cfile->file.name[len-5] = '\0';
             cfile->file.size = *(u32*)(cfile->data + LZMA_PROPERTIES_SIZE);
+        } else if (CONFIG_LZ4 && len > 4
+                   && strcmp(&cfile->file.name[len-4], ".lz4") == 0) {
+            // The frame must record the uncompressed size.
+            int size = ulz4_size(cfile->data, cfile->rawsize);
+            if (size >= 0) {
+                cfile->flags = CBFS_COMPRESS_LZ4;
+                cfile->file.name[len-4] = '\0';
+                cfile->file.size = size;
+            } else {
+                dprintf(1, "No content size in lz4 file %s\n"
+                        , cfile->file.name);
+            }
         }
         romfile_add(&cfile->file);
 
@@ -424,13 +465,154 @@ struct cbfs_payload_segment {
 #define PAYLOAD_SEGMENT_BSS    0x20535342
 #define PAYLOAD_SEGMENT_ENTRY  0x52544E45
 
-#define CBFS_COMPRESS_NONE  0
-#define CBFS_COMPRESS_LZMA  1
-
 struct cbfs_payload {
     struct cbfs_payload_segment segments[1];
 };
 
+// Compressed payload segments that are uncompressed by threads during
+// POST (see cbfs_payload_prefetch).  The temporary copies are moved to
+// their load addresses before boot (see cbfs_payload_prepboot).
+struct cbfs_prefetch_s {
+    struct cbfs_payload *pay;
+    struct cbfs_payload_segment *seg;
+    void *buf;
+    int len, placed;
+};
+static struct cbfs_prefetch_s *PayloadPrefetch;
+static int PayloadPrefetchCount;
+// Set while the segments moved into place at prepboot are intact.
+int PayloadPlaced VARLOW;
+
+// Check if a memory area overlaps the load area of any segment.
+static int
+cbfs_payload_overlap(struct cbfs_payload *pay, void *buf, u32 len)
+{
+    struct cbfs_payload_segment *seg;
+    for (seg = pay->segments; seg->type != PAYLOAD_SEGMENT_ENTRY; seg++) {
+        u32 dest = be64_to_cpu(seg->load_addr);
+        u32 dest_len = be32_to_cpu(seg->mem_len);
+        if ((u32)buf < dest + dest_len && dest < (u32)buf + len)
+            return 1;
+    }
+    return 0;
+}
+
+static void
+cbfs_prefetch_segment(void *data)
+{
+    struct cbfs_prefetch_s *pf = data;
+    struct cbfs_payload_segment *seg = pf->seg;
+    void *src = (void*)pf->pay + be32_to_cpu(seg->offset);
+    u32 src_len = be32_to_cpu(seg->len);
+    u32 dest_len = be32_to_cpu(seg->mem_len);
+
+    u32 buf_len = ALIGN(dest_len, PAGE_SIZE);
+    void *buf = memalign_tmphigh(PAGE_SIZE, buf_len);
+    if (!buf || cbfs_payload_overlap(pf->pay, buf, buf_len)) {
+        // The segment is uncompressed at boot instead.
+        free(buf);
+        return;
+    }
+    int ret;
+    if (seg->compression == cpu_to_be32(CBFS_COMPRESS_LZ4)) {
+        ret = ulz4(buf, dest_len, src, src_len);
+    } else {
+        // Threads have small stacks - allocate the decoder state.
+        void *scratch = malloc_tmphigh(LZMA_SCRATCH_SIZE);
+        if (!scratch) {
+            free(buf);
+            return;
+        }
+        ret = ulzma_scratch(buf, dest_len, src, src_len
+                            , scratch, LZMA_SCRATCH_SIZE);
+        free(scratch);
+    }
+    if (ret < 0) {
+        free(buf);
+        return;
+    }
+    pf->len = ret;
+    pf->buf = buf;
+}
+
+static int
+cbfs_segment_compressed(struct cbfs_payload_segment *seg)
+{
+    if (seg->type == PAYLOAD_SEGMENT_BSS)
+        return 0;
+    return ((CONFIG_LZMA && seg->compression == cpu_to_be32(CBFS_COMPRESS_LZMA))
+            || (CONFIG_LZ4
+                && seg->compression == cpu_to_be32(CBFS_COMPRESS_LZ4)));
+}
+
+// Start threads that uncompress the compressed segments of a payload.
+static void
+cbfs_payload_prefetch(struct cbfs_file *fhdr)
+{
+    struct cbfs_payload *pay = (void*)fhdr + be32_to_cpu(fhdr->offset);
+    struct cbfs_payload_segment *seg;
+    int count = 0;
+    for (seg = pay->segments; seg->type != PAYLOAD_SEGMENT_ENTRY; seg++)
+        if (cbfs_segment_compressed(seg))
+            count++;
+    if (!count)
+        return;
+    struct cbfs_prefetch_s *pfs = malloc_fseg(count * sizeof(pfs[0]));
+    if (!pfs) {
+        warn_noalloc();
+        return;
+    }
+    memset(pfs, 0, count * sizeof(pfs[0]));
+    PayloadPrefetch = pfs;
+    PayloadPrefetchCount = count;
+    for (seg = pay->segments; count; seg++) {
+        if (!cbfs_segment_compressed(seg))
+            continue;
+        struct cbfs_prefetch_s *pf = &pfs[--count];
+        pf->pay = pay;
+        pf->seg = seg;
+        run_thread(cbfs_prefetch_segment, pf);
+    }
+}
+
+// Move the uncompressed segments to their load addresses - the
+// temporary copies don't survive malloc_prepboot().  A segment is only
+// moved if its load area is unused temporary ram (so nothing in use is
+// overwritten and the area is free ram for any other boot choice);
+// otherwise it is uncompressed again at boot.
+void
+cbfs_payload_prepboot(void)
+{
+    int i;
+    for (i=0; i<PayloadPrefetchCount; i++) {
+        struct cbfs_prefetch_s *pf = &PayloadPrefetch[i];
+        if (!pf->buf)
+            continue;
+        void *dest = (void*)(u32)be64_to_cpu(pf->seg->load_addr);
+        u32 dest_len = be32_to_cpu(pf->seg->mem_len);
+        if (malloc_tmphigh_unused(dest, dest_len)) {
+            dprintf(3, "Moving prefetched segment %d@%p to %p\n"
+                    , pf->len, pf->buf, dest);
+            memcpy(dest, pf->buf, pf->len);
+            pf->placed = 1;
+            PayloadPlaced = 1;
+        }
+        free(pf->buf);
+        pf->buf = NULL;
+    }
+}
+
+// Find a segment that was moved into place at prepboot.
+static struct cbfs_prefetch_s *
+cbfs_find_prefetch(struct cbfs_payload_segment *seg)
+{
+    int i;
+    for (i=0; i<PayloadPrefetchCount; i++)
+        if (PayloadPrefetch[i].seg == seg && PayloadPrefetch[i].placed)
+            return &PayloadPrefetch[i];
+    return NULL;
+}
+
 void
 cbfs_run_payload(struct cbfs_file *fhdr)
 {
@@ -439,6 +621,10 @@ cbfs_run_payload(struct cbfs_file *fhdr)
     dprintf(1, "Run %s\n", fhdr->filename);
     struct cbfs_payload *pay = (void*)fhdr + be32_to_cpu(fhdr->offset);
     struct cbfs_payload_segment *seg = pay->segments;
+    // The placed segments are only intact on the first boot attempt
+    // (an earlier boot choice may have used that ram).
+    int placed = PayloadPlaced && !BootSequence;
+    PayloadPlaced = 0;
     for (;;) {
         void *src = (void*)pay + be32_to_cpu(seg->offset);
         void *dest = (void*)(u32)be64_to_cpu(seg->load_addr);
@@ -455,10 +641,16 @@ cbfs_run_payload(struct cbfs_file *fhdr)
             func();
             return;
         }
-        default:
+        default: {
             dprintf(3, "Segment %x %d@%p -> %d@%p\n"
                     , seg->type, src_len, src, dest_len, dest);
-            if (seg->compression == cpu_to_be32(CBFS_COMPRESS_NONE)) {
+            struct cbfs_prefetch_s *pf = NULL;
+            if (placed)
+                pf = cbfs_find_prefetch(seg);
+            if (pf) {
+                // Uncompressed during POST and already in place.
+                src_len = pf->len;
+            } else if (seg->compression == cpu_to_be32(CBFS_COMPRESS_NONE)) {
                 if (src_len > dest_len)
                     src_len = dest_len;
                 memcpy(dest, src, src_len);
@@ -468,6 +660,12 @@ cbfs_run_payload(struct cbfs_file *fhdr)
                 if (ret < 0)
                     return;
                 src_len = ret;
+            } else if (CONFIG_LZ4
+                       && seg->compression == cpu_to_be32(CBFS_COMPRESS_LZ4)) {
+                int ret = ulz4(dest, dest_len, src, src_len);
+                if (ret < 0)
+                    return;
+                src_len = ret;
             } else {
                 dprintf(1, "No support for compression type %x\n"
                         , seg->compression);
@@ -477,6 +675,7 @@ cbfs_run_payload(struct cbfs_file *fhdr)
                 memset(dest + src_len, 0, dest_len - src_len);
             break;
         }
+        }
         seg++;
     }
 }
@@ -496,6 +695,11 @@ cbfs_payload_setup(void)
         cfile = container_of(file, struct cbfs_romfile_s, file);
         const char *filename = file->name;
         char *desc = znprintf(MAXDESCSIZE, "Payload [%s]", &filename[4]);
-        boot_add_cbfs(cfile->fhdr, desc, bootprio_find_named_rom(filename, 0));
+        int prio = bootprio_find_named_rom(filename, 0);
+        if (CONFIG_THREADS && prio == 1 && !PayloadPrefetch)
+            // First boot choice - uncompress it while other devices
+            // are initialized.
+            cbfs_payload_prefetch(cfile->fhdr);
+        boot_add_cbfs(cfile->fhdr, desc, prio);
     }
 }
@@ -0,0 +1,171 @@
+// Decompression of lz4 frames (CBFS files and payload segments).
+//
+// This file may be distributed under the terms of the GNU LGPLv3 license.
+
+#include "util.h" // dprintf
+#include "config.h" // CONFIG_*
+
+#define LZ4_MAGIC 0x184D2204
+
+#define LZ4_FLG_VERSION_MASK 0xc0
+#define LZ4_FLG_VERSION      0x40
+#define LZ4_FLG_BLOCK_CHECK  0x10
+#define LZ4_FLG_CONTENT_SIZE 0x08
+#define LZ4_FLG_CONTENT_CHECK 0x04
+#define LZ4_FLG_DICTID       0x01
+
+#define LZ4_BLOCK_UNCOMPRESSED 0x80000000
+
+#define LZ4_MIN_MATCH 4
+
+// Parse the frame header - returns its length or -1 on error.
+static int
+lz4_frame_header(const u8 *src, u32 srclen, u8 *pflg, u64 *psize)
+{
+    if (srclen < 7 || *(u32*)src != LZ4_MAGIC)
+        return -1;
+    u8 flg = src[4];
+    if ((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION)
+        return -1;
+    int len = 7;
+    if (flg & LZ4_FLG_CONTENT_SIZE)
+        len += 8;
+    if (flg & LZ4_FLG_DICTID)
+        len += 4;
+    if (srclen < len)
+        return -1;
+    *pflg = flg;
+    *psize = 0;
+    if (flg & LZ4_FLG_CONTENT_SIZE)
+        *psize = *(u64*)&src[6];
+    return len;
+}
+
+// Return the uncompressed size recorded in a frame (or -1 if unknown).
+int
+ulz4_size(const u8 *src, u32 srclen)
+{
+    u8 flg;
+    u64 size;
+    if (lz4_frame_header(src, srclen, &flg, &size) < 0
+        || !(flg & LZ4_FLG_CONTENT_SIZE) || size > 0x7fffffff)
+        return -1;
+    return size;
+}
+
+// Read an lz4 length extension (a run of 255 bytes and a final byte).
+static int
+lz4_length(const u8 **pip, const u8 *iend, u32 *plen)
+{
+    const u8 *ip = *pip;
+    u8 b;
+    do {
+        if (ip >= iend)
+            return -1;
+        b = *ip++;
+        *plen += b;
+    } while (b == 255);
+    *pip = ip;
+    return 0;
+}
+
+// Uncompress one block - 'start' is the beginning of the frame output
+// (matches may reference data from earlier blocks).
+static int
+lz4_block(u8 *start, u8 *op, u8 *oend, const u8 *ip, const u8 *iend)
+{
+    u8 *obegin = op;
+    for (;;) {
+        if (ip >= iend)
+            return -1;
+        u8 token = *ip++;
+
+        // Literals.
+        u32 len = token >> 4;
+        if (len == 15 && lz4_length(&ip, iend, &len))
+            return -1;
+        if (len > iend - ip || len > oend - op)
+            return -1;
+        memcpy(op, ip, len);
+        op += len;
+        ip += len;
+        if (ip == iend)
+            // The last sequence only holds literals.
+            return op - obegin;
+
+        // Match.
+        if (iend - ip < 2)
+            return -1;
+        u32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (!offset || offset > op - start)
+            return -1;
+        len = token & 0x0f;
+        if (len == 15 && lz4_length(&ip, iend, &len))
+            return -1;
+        len += LZ4_MIN_MATCH;
+        if (len > oend - op)
+            return -1;
+        const u8 *match = op - offset;
+        if (offset >= 4)
+            for (; len >= 4; len -= 4, op += 4, match += 4)
+                memcpy(op, match, 4);
+        for (; len; len--)
+            *op++ = *match++;
+    }
+}
+
+// Uncompress an lz4 frame to an area of memory.  Block and content
+// checksums are skipped, not verified.
+int
+ulz4(u8 *dst, u32 maxlen, const u8 *src, u32 srclen)
+{
+    if (!CONFIG_LZ4)
+        return -1;
+    dprintf(3, "Uncompressing lz4 data %d@%p to %d@%p\n"
+            , srclen, src, maxlen, dst);
+    u8 flg;
+    u64 size;
+    int hdrlen = lz4_frame_header(src, srclen, &flg, &size);
+    if (hdrlen < 0) {
+        dprintf(1, "Invalid lz4 frame header\n");
+        return -1;
+    }
+    if ((flg & LZ4_FLG_CONTENT_SIZE) && size > maxlen) {
+        dprintf(1, "lz4 data too large (max %d need %d)\n", maxlen, (u32)size);
+        return -1;
+    }
+    const u8 *ip = src + hdrlen, *iend = src + srclen;
+    u8 *op = dst, *oend = dst + maxlen;
+    for (;;) {
+        if (iend - ip < 4)
+            goto fail;
+        u32 blocksize = *(u32*)ip;
+        ip += 4;
+        if (!blocksize)
+            // End mark.
+            break;
+        u32 len = blocksize & ~LZ4_BLOCK_UNCOMPRESSED;
+        if (len > iend - ip)
+            goto fail;
+        if (blocksize & LZ4_BLOCK_UNCOMPRESSED) {
+            if (len > oend - op)
+                goto fail;
+            memcpy(op, ip, len);
+            op += len;
+        } else {
+            int ret = lz4_block(dst, op, oend, ip, ip + len);
+            if (ret < 0)
+                goto fail;
+            op += ret;
+        }
+        ip += len;
+        if (flg & LZ4_FLG_BLOCK_CHECK)
+            ip += 4;
+    }
+    return op - dst;
+
+fail:
+    dprintf(1, "lz4 decompression error at %p\n", ip);
+    return -1;
+}
@@ -380,13 +380,20 @@ int LzmaDecode(CLzmaDecoderState *vs,
         return LZMA_RESULT_DATA_ERROR;
 
 
-      do
       {
-        previousByte = outStream[nowPos - rep0];
-        len--;
-        outStream[nowPos++] = previousByte;
+        /* copy the match - a word at a time when it doesn't overlap */
+        Byte *dest = outStream + nowPos;
+        const Byte *src = dest - rep0;
+        if ((SizeT)len > outSize - nowPos)
+          len = (int)(outSize - nowPos);
+        nowPos += len;
+        if (rep0 >= 4)
+          for (; len >= 4; len -= 4, dest += 4, src += 4)
+            __builtin_memcpy(dest, src, 4);
+        for (; len != 0; len--)
+          *dest++ = *src++;
+        previousByte = dest[-1];
       }
-      while(len != 0 && nowPos < outSize);
     }
   }
   RC_NORMALIZE;
@@ -544,6 +544,10 @@ ahci_port_detect(void *data)
     struct ahci_port_s *port = data;
     int rc;
 
+    if (boot_fast_path()) {
+        ahci_port_release(port);
+        return;
+    }
     dprintf(2, "AHCI/%d: probing\n", port->pnr);
     ahci_port_reset(port->ctrl, port->pnr);
     rc = ahci_port_setup(port);
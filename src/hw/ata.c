@@ -846,6 +846,8 @@ ata_detect(void *data)
     int didreset = 0;
     u8 slave;
     for (slave=0; slave<=1; slave++) {
+        if (boot_fast_path())
+            break;
         // Wait for not-bsy.
         u16 iobase1 = chan_gf->iobase1;
         int status = powerup_await_non_bsy(iobase1);
@@ -85,19 +85,25 @@ struct floppyinfo_s FloppyInfo[] VARFSEG = {
     { {2, 40, 8}, FLOPPY_SIZE_525, FLOPPY_RATE_250K},
 };
 
-struct drive_s *
-init_floppy(int floppyid, int ftype)
+// Cylinder read cache (see floppy_read_cached)
+struct floppy_cache_s {
+    u8 valid;
+    u8 floppyid;
+    u8 cylinder;
+};
+struct floppy_cache_s FloppyCache VARLOW;
+u8 *FloppyCacheBuf VARFSEG;
+u16 FloppyCacheSize VARFSEG;
+
+// Fill in a caller allocated drive_s for the given floppy type.
+int
+init_floppy_drive(struct drive_s *drive_g, int floppyid, int ftype)
 {
     if (ftype <= 0 || ftype >= ARRAY_SIZE(FloppyInfo)) {
         dprintf(1, "Bad floppy type %d\n", ftype);
-        return NULL;
+        return -1;
     }
 
-    struct drive_s *drive_g = malloc_fseg(sizeof(*drive_g));
-    if (!drive_g) {
-        warn_noalloc();
-        return NULL;
-    }
     memset(drive_g, 0, sizeof(*drive_g));
     drive_g->cntl_id = floppyid;
     drive_g->type = DTYPE_FLOPPY;
@@ -107,6 +113,21 @@ init_floppy(int floppyid, int ftype)
 
     memcpy(&drive_g->lchs, &FloppyInfo[ftype].chs
            , sizeof(FloppyInfo[ftype].chs));
+    return 0;
+}
+
+struct drive_s *
+init_floppy(int floppyid, int ftype)
+{
+    struct drive_s *drive_g = malloc_fseg(sizeof(*drive_g));
+    if (!drive_g) {
+        warn_noalloc();
+        return NULL;
+    }
+    if (init_floppy_drive(drive_g, floppyid, ftype)) {
+        free(drive_g);
+        return NULL;
+    }
     return drive_g;
 }
 
@@ -116,6 +137,9 @@ addFloppy(int floppyid, int ftype)
     struct drive_s *drive_g = init_floppy(floppyid, ftype);
     if (!drive_g)
         return;
+    u32 cylsize = drive_g->lchs.heads * drive_g->lchs.spt * DISK_SECTOR_SIZE;
+    if (cylsize > FloppyCacheSize)
+        FloppyCacheSize = cylsize;
     char *desc = znprintf(MAXDESCSIZE, "Floppy [drive %c]", 'A' + floppyid);
     struct pci_device *pci = pci_find_class(PCI_CLASS_BRIDGE_ISA); /* isa-to-pci bridge */
     int prio = bootprio_find_fdc_device(pci, PORT_FD_BASE, floppyid);
@@ -154,6 +178,31 @@ floppy_setup(void)
     enable_hwirq(6, FUNC16(entry_0e));
 }
 
+// Allocate the cylinder cache.  This is done at boot (after the option
+// roms have been placed) so that the low memory buffer does not take
+// space that an option rom could use.
+void
+floppy_prepboot(void)
+{
+    if (!CONFIG_FLOPPY_TRACK_CACHE || !FloppyCacheSize)
+        return;
+    u8 *buf = malloc_low(FloppyCacheSize);
+    if (buf && ((u32)buf ^ ((u32)buf + FloppyCacheSize - 1)) & ~0xffff) {
+        // The dma transfer can't cross a 64K boundary - use an aligned
+        // buffer instead.
+        free(buf);
+        u32 align = 1;
+        while (align < FloppyCacheSize)
+            align <<= 1;
+        buf = memalign_low(align, FloppyCacheSize);
+    }
+    if (!buf) {
+        warn_noalloc();
+        return;
+    }
+    FloppyCacheBuf = buf;
+}
+
 // Find a floppy type that matches a given image size.
 int
 find_floppy_type(u32 size)
@@ -419,6 +468,7 @@ check_recal_drive(struct drive_s *drive_g)
         return DISK_RET_SUCCESS;
 
     // Recalibrate drive.
+    SET_LOW(FloppyCache.valid, 0);
     int ret = floppy_drive_recal(floppyid);
     if (ret)
         return ret;
@@ -529,6 +579,7 @@ static int
 floppy_reset(struct disk_op_s *op)
 {
     u8 floppyid = GET_GLOBAL(op->drive_g->cntl_id);
+    SET_LOW(FloppyCache.valid, 0);
     SET_BDA(floppy_recalibration_status, 0);
     SET_BDA(floppy_media_state[0], 0);
     SET_BDA(floppy_media_state[1], 0);
@@ -539,9 +590,11 @@ floppy_reset(struct disk_op_s *op)
     return floppy_select_drive(floppyid);
 }
 
-// Read Diskette Sectors
+// Send a read-normal-data command.  The multi-track bit is set, so a
+// read with an 'eot' of the last sector on the track continues onto
+// the second head.  An 'eot' of zero reads only the requested sectors.
 static int
-floppy_read(struct disk_op_s *op)
+floppy_read_data(struct disk_op_s *op, u8 eot)
 {
     u8 track, sector, head;
     lba2chs(op, &track, &sector, &head);
@@ -557,10 +610,65 @@ floppy_read(struct disk_op_s *op)
     pio.data[4] = sector;
     pio.data[5] = FLOPPY_SIZE_CODE;
     pio.data[6] = sector + op->count - 1; // last sector to read on track
+    if (eot)
+        pio.data[6] = eot;
     pio.data[7] = FLOPPY_GAPLEN;
     pio.data[8] = FLOPPY_DATALEN;
 
-    int res = floppy_cmd(op, DISK_SECTOR_SIZE, &pio);
+    return floppy_cmd(op, DISK_SECTOR_SIZE, &pio);
+}
+
+// Serve a read from the cylinder cache - on a miss the whole cylinder
+// (both heads) is read into the cache with a single dma transfer.
+static int
+floppy_read_cached(struct disk_op_s *op)
+{
+    u8 *cache_fl = GET_GLOBAL(FloppyCacheBuf);
+    if (!cache_fl)
+        return -1;
+    struct drive_s *drive_g = op->drive_g;
+    u8 floppyid = GET_GLOBAL(drive_g->cntl_id);
+    u8 spt = GET_GLOBAL(drive_g->lchs.spt);
+    u32 cylsectors = spt * GET_GLOBAL(drive_g->lchs.heads);
+    if (cylsectors * DISK_SECTOR_SIZE > GET_GLOBAL(FloppyCacheSize))
+        return -1;
+    u32 cylinder = (u32)op->lba / cylsectors;
+    u32 start = cylinder * cylsectors;
+    if (op->lba + op->count > start + cylsectors)
+        // Request spans cylinders.
+        return -1;
+
+    if (!GET_LOW(FloppyCache.valid)
+        || GET_LOW(FloppyCache.floppyid) != floppyid
+        || GET_LOW(FloppyCache.cylinder) != cylinder) {
+        struct disk_op_s dop;
+        dop.drive_g = drive_g;
+        dop.command = CMD_READ;
+        dop.lba = start;
+        dop.count = cylsectors;
+        dop.buf_fl = cache_fl;
+        int ret = floppy_read_data(&dop, spt);
+        if (ret)
+            // Let the caller retry with a regular read.
+            return -1;
+        SET_LOW(FloppyCache.floppyid, floppyid);
+        SET_LOW(FloppyCache.cylinder, cylinder);
+        SET_LOW(FloppyCache.valid, 1);
+    }
+
+    memcpy_fl(op->buf_fl, cache_fl + (op->lba - start) * DISK_SECTOR_SIZE
+              , op->count * DISK_SECTOR_SIZE);
+    return 0;
+}
+
+// Read Diskette Sectors
+static int
+floppy_read(struct disk_op_s *op)
+{
+    if (CONFIG_FLOPPY_TRACK_CACHE && !floppy_read_cached(op))
+        return DISK_RET_SUCCESS;
+
+    int res = floppy_read_data(op, 0);
     if (res)
         goto fail;
     return DISK_RET_SUCCESS;
@@ -573,6 +681,8 @@ fail:
 static int
 floppy_write(struct disk_op_s *op)
 {
+    SET_LOW(FloppyCache.valid, 0);
+
     u8 track, sector, head;
     lba2chs(op, &track, &sector, &head);
 
@@ -624,6 +734,7 @@ static int
 floppy_format(struct disk_op_s *op)
 {
     u8 head = op->lba;
+    SET_LOW(FloppyCache.valid, 0);
 
     // send format-track command (6 bytes) to controller
     u8 floppyid = GET_GLOBAL(op->drive_g->cntl_id);
@@ -694,8 +805,11 @@ floppy_tick(void)
     if (fcount) {
         fcount--;
         SET_BDA(floppy_motor_counter, fcount);
-        if (fcount == 0)
-            // turn motor(s) off
+        if (fcount == 0) {
+            // turn motor(s) off - the media may be changed from now on
             outb(inb(PORT_FD_DOR) & 0xcf, PORT_FD_DOR);
+            if (CONFIG_FLOPPY_TRACK_CACHE)
+                SET_LOW(FloppyCache.valid, 0);
+        }
     }
 }
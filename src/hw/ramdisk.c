@@ -11,6 +11,142 @@
 #include "bregs.h" // struct bregs
 #include "boot.h" // boot_add_floppy
 
+struct ramdisk_s {
+    struct drive_s drive;
+    struct ramdisk_lz_s *lz;
+};
+
+
+/****************************************************************
+ * Chunked lzma images
+ ****************************************************************/
+
+// A "floppyimg/*.clzma" file holds a floppy image split into chunks
+// that are each lzma compressed.  The chunks are only uncompressed
+// when a disk request first touches them.
+#define RAMDISK_LZ_MAGIC 0x5a4c4453 // SDLZ
+
+struct ramdisk_lzhdr_s {
+    u32 magic;
+    u32 size;
+    u32 chunksize;
+    u32 count;
+    u32 offset[];
+} PACKED;
+
+struct ramdisk_lz_s {
+    struct ramdisk_lzhdr_s *hdr;
+    void *scratch;
+    u8 loaded[];
+};
+
+// Uncompress all chunks that overlap the bytes from 'start' to 'end'.
+static int
+ramdisk_lz_load(struct ramdisk_lz_s *lz, void *image, u32 start, u32 end)
+{
+    struct ramdisk_lzhdr_s *hdr = lz->hdr;
+    u32 chunk;
+    for (chunk = start / hdr->chunksize; chunk < hdr->count; chunk++) {
+        u32 pos = chunk * hdr->chunksize;
+        if (pos >= end)
+            break;
+        if (lz->loaded[chunk])
+            continue;
+        u32 len = hdr->size - pos;
+        if (len > hdr->chunksize)
+            len = hdr->chunksize;
+        int ret = ulzma_scratch(image + pos, len
+                                , (void*)hdr + hdr->offset[chunk]
+                                , hdr->offset[chunk+1] - hdr->offset[chunk]
+                                , lz->scratch, LZMA_SCRATCH_SIZE);
+        if (ret != len)
+            return -1;
+        lz->loaded[chunk] = 1;
+    }
+    return 0;
+}
+
+// Uncompress all chunks that overlap the given request.
+static int
+ramdisk_lz_prep(struct disk_op_s *op)
+{
+    struct ramdisk_s *rd = container_of(op->drive_g, struct ramdisk_s, drive);
+    u32 start = (u32)op->lba * DISK_SECTOR_SIZE;
+    return ramdisk_lz_load(rd->lz, (void*)rd->drive.cntl_id
+                           , start, start + op->count * DISK_SECTOR_SIZE);
+}
+
+// Copy a chunked image into ram and prepare it for lazy uncompressing
+// (or uncompress it now if CONFIG_FLASH_FLOPPY_LAZY is not set).
+static void *
+ramdisk_lz_setup(struct romfile_s *file, struct ramdisk_lz_s **plz, u32 *psize)
+{
+    if (!CONFIG_LZMA)
+        return NULL;
+
+    // Load the compressed chunks.
+    u32 rawsize = ALIGN(file->size, PAGE_SIZE);
+    struct ramdisk_lzhdr_s *hdr = memalign_tmphigh(PAGE_SIZE, rawsize);
+    if (!hdr) {
+        warn_noalloc();
+        return NULL;
+    }
+    int ret = file->copy(file, hdr, file->size);
+    if (ret < 0)
+        goto fail;
+    if (hdr->magic != RAMDISK_LZ_MAGIC || !hdr->chunksize
+        || hdr->chunksize % DISK_SECTOR_SIZE
+        || hdr->count != DIV_ROUND_UP(hdr->size, hdr->chunksize)
+        || sizeof(*hdr) + (hdr->count + 1) * sizeof(hdr->offset[0]) > file->size
+        || hdr->offset[hdr->count] > file->size) {
+        dprintf(1, "Invalid chunked ramdisk %s\n", file->name);
+        goto fail;
+    }
+
+    // Allocate the image and the decoder state.
+    struct ramdisk_lz_s *lz = malloc_high(sizeof(*lz) + hdr->count);
+    void *scratch = (CONFIG_FLASH_FLOPPY_LAZY ? malloc_high(LZMA_SCRATCH_SIZE)
+                     : malloc_tmphigh(LZMA_SCRATCH_SIZE));
+    void *pos = memalign_tmphigh(PAGE_SIZE, hdr->size);
+    if (!lz || !scratch || !pos) {
+        warn_noalloc();
+        free(lz);
+        free(scratch);
+        free(pos);
+        goto fail;
+    }
+    memset(lz->loaded, 0, hdr->count);
+    lz->hdr = hdr;
+    lz->scratch = scratch;
+    *psize = hdr->size;
+    if (!CONFIG_FLASH_FLOPPY_LAZY) {
+        ret = ramdisk_lz_load(lz, pos, 0, hdr->size);
+        free(lz);
+        free(scratch);
+        free(hdr);
+        if (ret) {
+            dprintf(1, "Unable to uncompress chunked ramdisk %s\n", file->name);
+            free(pos);
+            return NULL;
+        }
+        return pos;
+    }
+    add_e820((u32)hdr, rawsize, E820_RESERVED);
+    dprintf(3, "Chunked ramdisk %s: %d chunks of %d bytes\n"
+            , file->name, hdr->count, hdr->chunksize);
+    *plz = lz;
+    return pos;
+
+fail:
+    free(hdr);
+    return NULL;
+}
+
+
+/****************************************************************
+ * Setup
+ ****************************************************************/
+
 void
 ramdisk_setup(void)
 {
@@ -24,37 +160,79 @@ ramdisk_setup(void)
     const char *filename = file->name;
     u32 size = file->size;
     dprintf(3, "Found floppy file %s of size %d\n", filename, size);
+
+    void *pos;
+    struct ramdisk_lz_s *lz = NULL;
+    int len = strlen(filename);
+    int chunked = len > 6 && strcmp(&filename[len-6], ".clzma") == 0;
+    if (chunked) {
+        pos = ramdisk_lz_setup(file, &lz, &size);
+        if (!pos)
+            return;
+    } else {
+        // Allocate ram for image.
+        pos = memalign_tmphigh(PAGE_SIZE, size);
+        if (!pos) {
+            warn_noalloc();
+            return;
+        }
+    }
     int ftype = find_floppy_type(size);
     if (ftype < 0) {
         dprintf(3, "No floppy type found for ramdisk size\n");
         return;
     }
-
-    // Allocate ram for image.
-    void *pos = memalign_tmphigh(PAGE_SIZE, size);
-    if (!pos) {
-        warn_noalloc();
-        return;
-    }
     add_e820((u32)pos, size, E820_RESERVED);
 
     // Copy image into ram.
-    int ret = file->copy(file, pos, size);
-    if (ret < 0)
-        return;
+    if (!chunked) {
+        int ret = file->copy(file, pos, size);
+        if (ret < 0)
+            return;
+    }
 
     // Setup driver.
-    struct drive_s *drive_g = init_floppy((u32)pos, ftype);
-    if (!drive_g)
+    struct ramdisk_s *rd = malloc_fseg(sizeof(*rd));
+    if (!rd) {
+        warn_noalloc();
+        return;
+    }
+    if (init_floppy_drive(&rd->drive, (u32)pos, ftype)) {
+        free(rd);
         return;
-    drive_g->type = DTYPE_RAMDISK;
+    }
+    rd->drive.type = DTYPE_RAMDISK;
+    rd->lz = lz;
     dprintf(1, "Mapping CBFS floppy %s to addr %p\n", filename, pos);
     char *desc = znprintf(MAXDESCSIZE, "Ramdisk [%s]", &filename[10]);
-    boot_add_floppy(drive_g, desc, bootprio_find_named_rom(filename, 0));
+    boot_add_floppy(&rd->drive, desc, bootprio_find_named_rom(filename, 0));
+}
+
+
+/****************************************************************
+ * Disk requests
+ ****************************************************************/
+
+// Copy data between the image and the request buffer with a flat
+// memcpy - not limited to the 64KiB of an int 1587 block move.
+int VISIBLE32FLAT
+ramdisk_copy_flat(struct disk_op_s *op)
+{
+    struct ramdisk_s *rd = container_of(op->drive_g, struct ramdisk_s, drive);
+    if (CONFIG_FLASH_FLOPPY_LAZY && rd->lz && ramdisk_lz_prep(op))
+        return -1;
+    void *pos = (void*)rd->drive.cntl_id + (u32)op->lba * DISK_SECTOR_SIZE;
+    u32 len = op->count * DISK_SECTOR_SIZE;
+    if (op->command == CMD_WRITE)
+        memcpy(pos, op->buf_fl, len);
+    else
+        memcpy(op->buf_fl, pos, len);
+    return 0;
 }
 
+// Copy data using the int 1587 block move.
 static int
-ramdisk_copy(struct disk_op_s *op, int iswrite)
+ramdisk_copy_int1587(struct disk_op_s *op, int iswrite)
 {
     u32 offset = GET_GLOBAL(op->drive_g->cntl_id);
     offset += (u32)op->lba * DISK_SECTOR_SIZE;
@@ -85,6 +263,33 @@ ramdisk_copy(struct disk_op_s *op, int iswrite)
     return DISK_RET_SUCCESS;
 }
 
+static int
+ramdisk_copy(struct disk_op_s *op, int iswrite)
+{
+    int ret;
+    if (MODESEGMENT) {
+        extern void _cfunc32flat_ramdisk_copy_flat(struct disk_op_s *op);
+        ret = call32(_cfunc32flat_ramdisk_copy_flat
+                     , (u32)MAKE_FLATPTR(GET_SEG(SS), op), -2);
+        if (ret == -2) {
+            // Can't enter 32bit mode from 16bit protected mode - fall
+            // back to the bios block move.  Only fully loaded images can
+            // be read this way (see CONFIG_FLASH_FLOPPY_LAZY).
+            struct ramdisk_s *rd_g = container_of(
+                op->drive_g, struct ramdisk_s, drive);
+            if (!CONFIG_FLASH_FLOPPY_LAZY || !GET_GLOBAL(rd_g->lz))
+                return ramdisk_copy_int1587(op, iswrite);
+        }
+    } else {
+        ret = ramdisk_copy_flat(op);
+    }
+    if (ret) {
+        op->count = 0;
+        return DISK_RET_EBADTRACK;
+    }
+    return DISK_RET_SUCCESS;
+}
+
 int
 process_ramdisk_op(struct disk_op_s *op)
 {
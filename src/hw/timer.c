@@ -21,6 +21,7 @@
 u32 TimerKHz VARFSEG;
 u16 TimerPort VARFSEG;
 u8 ShiftTSC VARFSEG;
+u32 TimerTSCKHz VARFSEG;
 
 
 /****************************************************************
@@ -60,7 +61,7 @@ tsctimer_setup(void)
         ShiftTSC++;
         t = (t + 1) >> 1;
     }
-    TimerKHz = DIV_ROUND_UP((u32)t, 1000 * PMTIMER_TO_PIT);
+    TimerKHz = TimerTSCKHz = DIV_ROUND_UP((u32)t, 1000 * PMTIMER_TO_PIT);
 
     dprintf(1, "CPU Mhz=%u\n", (TimerKHz << ShiftTSC) / 1000);
 }
@@ -157,7 +158,7 @@ timer_sleep(u32 diff)
     u32 start = timer_read();
     u32 end = start + diff;
     while (!timer_check(end))
-        yield();
+        yield_until(end);
 }
 
 void ndelay(u32 count) {
@@ -192,6 +193,40 @@ timer_calc_usec(u32 usecs)
     return timer_read() + DIV_ROUND_UP(GET_GLOBAL(TimerKHz) * usecs, 1000);
 }
 
+static u32
+timer_ticks_to_usec(u32 ticks, u32 khz)
+{
+    if (!khz)
+        return 0;
+    return (ticks / khz) * 1000 + (ticks % khz) * 1000 / khz;
+}
+
+// Return the number of microseconds since 'start' (a timer_calc(0) value).
+u32
+timer_elapsed_usec(u32 start)
+{
+    return timer_ticks_to_usec(timer_read() - start, GET_GLOBAL(TimerKHz));
+}
+
+// Convert a TSC value to microseconds.  Returns zero if the TSC
+// hasn't been calibrated.
+u32
+timer_tsc_to_usec(u64 tsc)
+{
+    return timer_ticks_to_usec(tsc >> GET_GLOBAL(ShiftTSC)
+                               , GET_GLOBAL(TimerTSCKHz));
+}
+
+// Return the time since cpu reset in microseconds (or zero on cpus
+// without a TSC).
+u32
+timer_read_usec(void)
+{
+    if (!GET_GLOBAL(TimerTSCKHz))
+        return 0;
+    return timer_tsc_to_usec(rdtscll());
+}
+
 
 /****************************************************************
  * IRQ based timer
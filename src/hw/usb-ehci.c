@@ -691,6 +691,14 @@ ehci_send_bulk(struct usb_pipe *p, int dir, void *data, int datasize)
     return 0;
 }
 
+void
+ehci_reset_toggle(struct usb_pipe *p)
+{
+    ASSERT32FLAT();
+    struct ehci_pipe *pipe = container_of(p, struct ehci_pipe, pipe);
+    pipe->qh.token &= ~QTD_TOGGLE;
+}
+
 int
 ehci_poll_intr(struct usb_pipe *p, void *data)
 {
@@ -11,6 +11,7 @@ struct usb_pipe;
 int ehci_control(struct usb_pipe *p, int dir, const void *cmd, int cmdsize
                  , void *data, int datasize);
 int ehci_send_bulk(struct usb_pipe *p, int dir, void *data, int datasize);
+void ehci_reset_toggle(struct usb_pipe *p);
 int ehci_poll_intr(struct usb_pipe *p, void *data);
 
 
@@ -15,8 +15,9 @@
 
 struct usbdrive_s {
     struct drive_s drive;
-    struct usb_pipe *bulkin, *bulkout;
+    struct usb_pipe *bulkin, *bulkout, *defpipe;
     int lun;
+    u8 iface;
 };
 
 
@@ -26,6 +27,9 @@ struct usbdrive_s {
 
 #define USB_CDB_SIZE 12
 
+#define USB_MSC_RESET 0xff
+#define USB_MSC_RETRIES 2
+
 #define CBW_SIGNATURE 0x43425355 // USBC
 
 struct cbw_s {
@@ -58,6 +62,77 @@ usb_msc_send(struct usbdrive_s *udrive_g, int dir, void *buf, u32 bytes)
     return usb_send_bulk(pipe, dir, buf, bytes);
 }
 
+// Tag of the last command block wrapper sent to any drive.
+u32 MscTag VARLOW;
+
+// Perform Bulk-Only Mass Storage Reset recovery on a drive.
+static int
+usb_msc_reset(struct usbdrive_s *udrive_g)
+{
+    ASSERT32FLAT();
+    dprintf(1, "Resetting USB MSC drive %p\n", udrive_g);
+    struct usb_ctrlrequest req;
+    req.bRequestType = USB_DIR_OUT | USB_TYPE_CLASS | USB_RECIP_INTERFACE;
+    req.bRequest = USB_MSC_RESET;
+    req.wValue = 0;
+    req.wIndex = udrive_g->iface;
+    req.wLength = 0;
+    int ret = send_default_control(udrive_g->defpipe, &req, NULL);
+    if (ret)
+        return ret;
+    ret = usb_clear_halt(udrive_g->defpipe, udrive_g->bulkin, USB_DIR_IN);
+    if (ret)
+        return ret;
+    return usb_clear_halt(udrive_g->defpipe, udrive_g->bulkout, USB_DIR_OUT);
+}
+
+// Run one command/data/status sequence.  Returns 0 if a valid CSW
+// was received, or -1 if the transport failed.
+static int
+usb_msc_transfer(struct usbdrive_s *udrive_g, struct cbw_s *cbw
+                 , void *buf, struct csw_s *csw)
+{
+    u32 tag = GET_LOW(MscTag) + 1;
+    SET_LOW(MscTag, tag);
+    cbw->dCBWTag = tag;
+
+    // Transfer cbw to device.
+    int ret = usb_msc_send(udrive_g, USB_DIR_OUT
+                           , MAKE_FLATPTR(GET_SEG(SS), cbw), sizeof(*cbw));
+    if (ret)
+        return -1;
+
+    // Transfer data to/from device.  A stalled data stage is still
+    // followed by a csw once the endpoint halt is cleared.
+    u32 bytes = cbw->dCBWDataTransferLength;
+    if (bytes) {
+        ret = usb_msc_send(udrive_g, cbw->bmCBWFlags, buf, bytes);
+        if (ret) {
+            if (MODESEGMENT)
+                return -1;
+            struct usb_pipe *pipe = (cbw->bmCBWFlags == USB_DIR_IN
+                                     ? udrive_g->bulkin : udrive_g->bulkout);
+            ret = usb_clear_halt(udrive_g->defpipe, pipe, cbw->bmCBWFlags);
+            if (ret)
+                return -1;
+        }
+    }
+
+    // Transfer csw info.
+    ret = usb_msc_send(udrive_g, USB_DIR_IN
+                       , MAKE_FLATPTR(GET_SEG(SS), csw), sizeof(*csw));
+    if (ret && !MODESEGMENT) {
+        // Retry once after clearing a stalled bulk-in endpoint.
+        ret = usb_clear_halt(udrive_g->defpipe, udrive_g->bulkin, USB_DIR_IN);
+        if (!ret)
+            ret = usb_msc_send(udrive_g, USB_DIR_IN
+                               , MAKE_FLATPTR(GET_SEG(SS), csw), sizeof(*csw));
+    }
+    if (ret || csw->dCSWSignature != CSW_SIGNATURE || csw->dCSWTag != tag)
+        return -1;
+    return 0;
+}
+
 // Low-level usb command transmit function.
 int
 usb_cmd_data(struct disk_op_s *op, void *cdbcmd, u16 blocksize)
@@ -76,44 +151,38 @@ usb_cmd_data(struct disk_op_s *op, void *cdbcmd, u16 blocksize)
     memset(&cbw, 0, sizeof(cbw));
     memcpy(cbw.CBWCB, cdbcmd, USB_CDB_SIZE);
     cbw.dCBWSignature = CBW_SIGNATURE;
-    cbw.dCBWTag = 999; // XXX
     cbw.dCBWDataTransferLength = bytes;
     cbw.bmCBWFlags = cdb_is_read(cdbcmd, blocksize) ? USB_DIR_IN : USB_DIR_OUT;
     cbw.bCBWLUN = GET_GLOBAL(udrive_g->lun);
     cbw.bCBWCBLength = USB_CDB_SIZE;
 
-    // Transfer cbw to device.
-    int ret = usb_msc_send(udrive_g, USB_DIR_OUT
-                           , MAKE_FLATPTR(GET_SEG(SS), &cbw), sizeof(cbw));
-    if (ret)
-        goto fail;
-
-    // Transfer data to/from device.
-    if (bytes) {
-        ret = usb_msc_send(udrive_g, cbw.bmCBWFlags, op->buf_fl, bytes);
-        if (ret)
+    // Control transfers are only available during POST, so reset
+    // recovery (and thus retrying) is only done from 32bit mode.
+    struct csw_s csw;
+    int retries = MODESEGMENT ? 1 : USB_MSC_RETRIES;
+    for (;;) {
+        int ret = usb_msc_transfer(udrive_g, &cbw, op->buf_fl, &csw);
+        if (!ret)
+            break;
+        dprintf(1, "USB transmission failed\n");
+        if (!--retries || MODESEGMENT || usb_msc_reset(udrive_g))
             goto fail;
     }
 
-    // Transfer csw info.
-    struct csw_s csw;
-    ret = usb_msc_send(udrive_g, USB_DIR_IN
-                        , MAKE_FLATPTR(GET_SEG(SS), &csw), sizeof(csw));
-    if (ret)
-        goto fail;
-
     if (!csw.bCSWStatus)
         return DISK_RET_SUCCESS;
-    if (csw.bCSWStatus == 2)
+    if (csw.bCSWStatus == 2) {
+        // Phase error - the device requires reset recovery.
+        if (!MODESEGMENT)
+            usb_msc_reset(udrive_g);
         goto fail;
+    }
 
     if (blocksize)
         op->count -= csw.dCSWDataResidue / blocksize;
     return DISK_RET_EBADTRACK;
 
 fail:
-    // XXX - reset connection
-    dprintf(1, "USB transmission failed\n");
     op->count = 0;
     return DISK_RET_EBADTRACK;
 }
@@ -148,7 +217,9 @@ usb_msc_lun_setup(struct usb_pipe *inpipe, struct usb_pipe *outpipe,
     udrive_g->drive.type = DTYPE_USB;
     udrive_g->bulkin = inpipe;
     udrive_g->bulkout = outpipe;
+    udrive_g->defpipe = usbdev->defpipe;
     udrive_g->lun = lun;
+    udrive_g->iface = usbdev->iface->bInterfaceNumber;
 
     int prio = bootprio_find_usb(usbdev, lun);
     int ret = scsi_drive_setup(&udrive_g->drive, "USB MSC", prio);
@@ -206,6 +277,8 @@ usb_msc_setup(struct usbdevice_s *usbdev)
     if (!pipesused)
         goto fail;
 
+    // Keep the control pipe for reset recovery.
+    usbdev->defpipe = NULL;
     return 0;
 fail:
     dprintf(1, "Unable to configure USB MSC device.\n");
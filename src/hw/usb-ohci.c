@@ -496,6 +496,15 @@ ohci_send_bulk(struct usb_pipe *p, int dir, void *data, int datasize)
     return -1;
 }
 
+// Restart a halted endpoint - clear the halt bit and the toggle carry.
+void
+ohci_reset_pipe(struct usb_pipe *p)
+{
+    ASSERT32FLAT();
+    struct ohci_pipe *pipe = container_of(p, struct ohci_pipe, pipe);
+    pipe->ed.hwHeadP &= ~(ED_C|ED_H);
+}
+
 int
 ohci_poll_intr(struct usb_pipe *p, void *data)
 {
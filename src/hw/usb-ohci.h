@@ -11,6 +11,7 @@ struct usb_pipe;
 int ohci_control(struct usb_pipe *p, int dir, const void *cmd, int cmdsize
                  , void *data, int datasize);
 int ohci_send_bulk(struct usb_pipe *p, int dir, void *data, int datasize);
+void ohci_reset_pipe(struct usb_pipe *p);
 int ohci_poll_intr(struct usb_pipe *p, void *data);
 
 
@@ -22,6 +22,7 @@
 #include "disk.h" // DTYPE_UAS
 #include "boot.h" // bootprio_find_usb
 #include "usb-uas.h" // usb_uas_init
+#include "byteorder.h" // cpu_to_be16
 
 #define UAS_UI_COMMAND              0x01
 #define UAS_UI_SENSE                0x03
@@ -87,6 +88,32 @@ struct uasdrive_s {
     int lun;
 };
 
+// Maximum number of tagged commands kept in flight for a single request.
+#define UAS_MAX_TAGS                4
+// Minimum number of blocks per tagged command when splitting a request.
+#define UAS_MIN_SPLIT               16
+
+// Send a command information unit for the blocks [start, start+count).
+static int
+uas_send_command(struct uasdrive_s *drive, u8 *cdbcmd, u16 tag
+                 , int split, u32 start, u16 count)
+{
+    uas_ui ui;
+    memset(&ui, 0, sizeof(ui));
+    ui.hdr.id = UAS_UI_COMMAND;
+    ui.hdr.tag = cpu_to_be16(tag);
+    ui.command.lun[1] = GET_GLOBAL(drive->lun);
+    memcpy(ui.command.cdb, cdbcmd, sizeof(ui.command.cdb));
+    if (split) {
+        struct cdb_rwdata_10 *cmd = (void*)ui.command.cdb;
+        cmd->lba = cpu_to_be32(be32_to_cpu(cmd->lba) + start);
+        cmd->count = cpu_to_be16(count);
+    }
+    return usb_send_bulk(GET_GLOBAL(drive->command),
+                         USB_DIR_OUT, MAKE_FLATPTR(GET_SEG(SS), &ui),
+                         sizeof(ui.hdr) + sizeof(ui.command));
+}
+
 int
 uas_cmd_data(struct disk_op_s *op, void *cdbcmd, u16 blocksize)
 {
@@ -96,68 +123,90 @@ uas_cmd_data(struct disk_op_s *op, void *cdbcmd, u16 blocksize)
     struct uasdrive_s *drive = container_of(
         op->drive_g, struct uasdrive_s, drive);
 
-    uas_ui ui;
-    memset(&ui, 0, sizeof(ui));
-    ui.hdr.id = UAS_UI_COMMAND;
-    ui.hdr.tag = 0xdead;
-    ui.command.lun[1] = drive->lun;
-    memcpy(ui.command.cdb, cdbcmd, sizeof(ui.command.cdb));
-    int ret = usb_send_bulk(GET_GLOBAL(drive->command),
-                            USB_DIR_OUT, MAKE_FLATPTR(GET_SEG(SS), &ui),
-                            sizeof(ui.hdr) + sizeof(ui.command));
-    if (ret) {
-        dprintf(1, "uas: command send fail");
-        goto fail;
+    // Large reads and writes are split into several tagged commands
+    // that are all queued on the device before the first data phase,
+    // so the device can prepare the next chunk while the current one
+    // is transferred.  Other commands use a single tag.
+    u8 *cdb = cdbcmd;
+    int count = op->count, tags = 1;
+    int split = ((cdb[0] == CDB_CMD_READ_10 || cdb[0] == CDB_CMD_WRITE_10)
+                 && count >= UAS_MIN_SPLIT * 2);
+    if (split) {
+        tags = count / UAS_MIN_SPLIT;
+        if (tags > UAS_MAX_TAGS)
+            tags = UAS_MAX_TAGS;
     }
+    int chunk = DIV_ROUND_UP(count, tags);
 
-    memset(&ui, 0xff, sizeof(ui));
-    ret = usb_send_bulk(GET_GLOBAL(drive->status),
-                        USB_DIR_IN, MAKE_FLATPTR(GET_SEG(SS), &ui), sizeof(ui));
-    if (ret) {
-        dprintf(1, "uas: status recv fail");
-        goto fail;
+    // Queue all commands.  Tags are 1-based; tag N covers the blocks
+    // starting at (N-1)*chunk.
+    int i, ret;
+    for (i=0; i<tags; i++) {
+        u32 start = i * chunk;
+        u16 cnt = count - start < chunk ? count - start : chunk;
+        ret = uas_send_command(drive, cdb, i + 1, split, start, cnt);
+        if (ret) {
+            dprintf(1, "uas: command send fail");
+            goto fail;
+        }
     }
 
-    switch (ui.hdr.id) {
-    case UAS_UI_SENSE:
-        goto have_sense;
-    case UAS_UI_READ_READY:
-        ret = usb_send_bulk(GET_GLOBAL(drive->data_in),
-                            USB_DIR_IN, op->buf_fl, op->count * blocksize);
+    // Service data requests and sense reports in the order the device
+    // chooses until every tag has completed.
+    u8 done = 0, failed = 0;
+    uas_ui ui;
+    while (done != (1 << tags) - 1) {
+        memset(&ui, 0xff, sizeof(ui));
+        ret = usb_send_bulk(GET_GLOBAL(drive->status),
+                            USB_DIR_IN, MAKE_FLATPTR(GET_SEG(SS), &ui),
+                            sizeof(ui));
         if (ret) {
-            dprintf(1, "uas: data read fail");
+            dprintf(1, "uas: status recv fail");
             goto fail;
         }
-        break;
-    case UAS_UI_WRITE_READY:
-        ret = usb_send_bulk(GET_GLOBAL(drive->data_out),
-                            USB_DIR_OUT, op->buf_fl, op->count * blocksize);
-        if (ret) {
-            dprintf(1, "uas: data write fail");
+        int tag = be16_to_cpu(ui.hdr.tag);
+        if (tag < 1 || tag > tags || done & (1 << (tag - 1))) {
+            dprintf(1, "uas: unexpected tag %d", tag);
             goto fail;
         }
-        break;
-    default:
-        dprintf(1, "uas: unknown status ui id %d", ui.hdr.id);
-        goto fail;
-    }
+        u32 start = (tag - 1) * chunk;
+        u32 cnt = count - start < chunk ? count - start : chunk;
+        void *buf = op->buf_fl + start * blocksize;
 
-    memset(&ui, 0xff, sizeof(ui));
-    ret = usb_send_bulk(GET_GLOBAL(drive->status),
-                        USB_DIR_IN, MAKE_FLATPTR(GET_SEG(SS), &ui), sizeof(ui));
-    if (ret) {
-        dprintf(1, "uas: status recv fail");
-        goto fail;
-    }
-    if (ui.hdr.id != UAS_UI_SENSE) {
-        dprintf(1, "uas: expected sense ui, got ui id %d", ui.hdr.id);
-        goto fail;
+        switch (ui.hdr.id) {
+        case UAS_UI_SENSE:
+            done |= 1 << (tag - 1);
+            if (ui.sense.status)
+                failed |= 1 << (tag - 1);
+            break;
+        case UAS_UI_READ_READY:
+            ret = usb_send_bulk(GET_GLOBAL(drive->data_in),
+                                USB_DIR_IN, buf, cnt * blocksize);
+            if (ret) {
+                dprintf(1, "uas: data read fail");
+                goto fail;
+            }
+            break;
+        case UAS_UI_WRITE_READY:
+            ret = usb_send_bulk(GET_GLOBAL(drive->data_out),
+                                USB_DIR_OUT, buf, cnt * blocksize);
+            if (ret) {
+                dprintf(1, "uas: data write fail");
+                goto fail;
+            }
+            break;
+        default:
+            dprintf(1, "uas: unknown status ui id %d", ui.hdr.id);
+            goto fail;
+        }
     }
 
-have_sense:
-    if (ui.sense.status == 0) {
+    if (!failed)
         return DISK_RET_SUCCESS;
-    }
+    // Report the blocks of the leading chunks that completed successfully.
+    for (i=0; !(failed & (1 << i)); i++)
+        ;
+    op->count = i * chunk;
 
 fail:
     return DISK_RET_EBADTRACK;
@@ -546,6 +546,14 @@ fail:
     return -1;
 }
 
+void
+uhci_reset_toggle(struct usb_pipe *p)
+{
+    ASSERT32FLAT();
+    struct uhci_pipe *pipe = container_of(p, struct uhci_pipe, pipe);
+    pipe->toggle = 0;
+}
+
 int
 uhci_poll_intr(struct usb_pipe *p, void *data)
 {
@@ -11,6 +11,7 @@ struct usb_pipe;
 int uhci_control(struct usb_pipe *p, int dir, const void *cmd, int cmdsize
                  , void *data, int datasize);
 int uhci_send_bulk(struct usb_pipe *p, int dir, void *data, int datasize);
+void uhci_reset_toggle(struct usb_pipe *p);
 int uhci_poll_intr(struct usb_pipe *p, void *data);
 
 
@@ -18,6 +18,7 @@
 #include "usb-uas.h" // usb_uas_setup
 #include "usb.h" // struct usb_s
 #include "biosvar.h" // GET_GLOBAL
+#include "boot.h" // bootprio_find_usb_port
 
 
 /****************************************************************
@@ -99,6 +100,37 @@ send_default_control(struct usb_pipe *pipe, const struct usb_ctrlrequest *req
                         , req, sizeof(*req), data, req->wLength);
 }
 
+// Clear the halt feature of a bulk endpoint and reset its data toggle.
+int
+usb_clear_halt(struct usb_pipe *defpipe, struct usb_pipe *pipe, int dir)
+{
+    ASSERT32FLAT();
+    struct usb_ctrlrequest req;
+    req.bRequestType = USB_DIR_OUT | USB_TYPE_STANDARD | USB_RECIP_ENDPOINT;
+    req.bRequest = USB_REQ_CLEAR_FEATURE;
+    req.wValue = USB_ENDPOINT_HALT;
+    req.wIndex = pipe->ep | dir;
+    req.wLength = 0;
+    int ret = send_default_control(defpipe, &req, NULL);
+    if (ret)
+        return ret;
+
+    // The device restarts the endpoint at DATA0.
+    switch (pipe->type) {
+    default:
+    case USB_TYPE_UHCI:
+        uhci_reset_toggle(pipe);
+        break;
+    case USB_TYPE_OHCI:
+        ohci_reset_pipe(pipe);
+        break;
+    case USB_TYPE_EHCI:
+        ehci_reset_toggle(pipe);
+        break;
+    }
+    return 0;
+}
+
 // Free an allocated control or bulk pipe.
 void
 free_pipe(struct usb_pipe *pipe)
@@ -347,6 +379,9 @@ usb_hub_port_setup(void *data)
     struct usbdevice_s *usbdev = data;
     struct usbhub_s *hub = usbdev->hub;
     u32 port = usbdev->port;
+    int bootport = usbdev->bootprio >= 0;
+    if (boot_first_ready())
+        goto done;
 
     // Detect if device present (and possibly start reset)
     int ret = hub->op->detect(hub, port);
@@ -354,8 +389,17 @@ usb_hub_port_setup(void *data)
         // No device present
         goto done;
 
+    // Ports not in the boot order wait for those that are.
+    if (!bootport)
+        while (hub->bootthreads)
+            wait_thread_queue(&hub->threadwait);
+
     // Reset port and determine device speed
     mutex_lock(&hub->cntl->resetlock);
+    if (boot_first_ready()) {
+        hub->op->disconnect(hub, port);
+        goto resetfail;
+    }
     ret = hub->op->reset(hub, port);
     if (ret < 0)
         // Reset failed
@@ -370,6 +414,13 @@ usb_hub_port_setup(void *data)
     }
     mutex_unlock(&hub->cntl->resetlock);
 
+    // The other ports may proceed once the boot order ports are addressed.
+    if (bootport) {
+        bootport = 0;
+        hub->bootthreads--;
+        wake_threads(&hub->threadwait);
+    }
+
     // Configure the device
     int count = configure_usb_device(usbdev);
     free_pipe(usbdev->defpipe);
@@ -377,7 +428,10 @@ usb_hub_port_setup(void *data)
         hub->op->disconnect(hub, port);
     hub->devcount += count;
 done:
+    if (bootport)
+        hub->bootthreads--;
     hub->threads--;
+    wake_threads(&hub->threadwait);
     free(usbdev);
     return;
 
@@ -391,24 +445,35 @@ usb_enumerate(struct usbhub_s *hub)
 {
     u32 portcount = hub->portcount;
     hub->threads = portcount;
-
-    // Launch a thread for every port.
-    int i;
-    for (i=0; i<portcount; i++) {
-        struct usbdevice_s *usbdev = malloc_tmphigh(sizeof(*usbdev));
-        if (!usbdev) {
-            warn_noalloc();
-            continue;
+    hub->bootthreads = 0;
+
+    // Launch a thread for every port - ports that lead to a device in
+    // the boot order are started first and reset ahead of the others.
+    int pass, i;
+    for (pass=0; pass<2; pass++) {
+        for (i=0; i<portcount; i++) {
+            int prio = bootprio_find_usb_port(hub, i);
+            if ((prio < 0) != pass)
+                continue;
+            struct usbdevice_s *usbdev = malloc_tmphigh(sizeof(*usbdev));
+            if (!usbdev) {
+                warn_noalloc();
+                hub->threads--;
+                continue;
+            }
+            memset(usbdev, 0, sizeof(*usbdev));
+            usbdev->hub = hub;
+            usbdev->port = i;
+            usbdev->bootprio = prio;
+            if (prio >= 0)
+                hub->bootthreads++;
+            run_thread(usb_hub_port_setup, usbdev);
         }
-        memset(usbdev, 0, sizeof(*usbdev));
-        usbdev->hub = hub;
-        usbdev->port = i;
-        run_thread(usb_hub_port_setup, usbdev);
     }
 
     // Wait for threads to complete.
     while (hub->threads)
-        yield();
+        wait_thread_queue(&hub->threadwait);
 }
 
 void
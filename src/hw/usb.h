@@ -26,6 +26,7 @@ struct usbdevice_s {
     struct usb_config_descriptor *config;
     struct usb_interface_descriptor *iface;
     int imax;
+    int bootprio;
     u8 speed;
     u8 devaddr;
 };
@@ -49,6 +50,8 @@ struct usbhub_s {
     u32 powerwait;
     u32 port;
     u32 threads;
+    u32 bootthreads;
+    struct hlist_head threadwait;
     u32 portcount;
     u32 devcount;
 };
@@ -115,6 +118,8 @@ struct usbhub_op_s {
 #define USB_REQ_SET_INTERFACE           0x0B
 #define USB_REQ_SYNCH_FRAME             0x0C
 
+#define USB_ENDPOINT_HALT               0x00
+
 struct usb_ctrlrequest {
     u8 bRequestType;
     u8 bRequest;
@@ -227,6 +232,7 @@ int usb_send_bulk(struct usb_pipe *pipe, int dir, void *data, int datasize);
 int usb_poll_intr(struct usb_pipe *pipe, void *data);
 int send_default_control(struct usb_pipe *pipe, const struct usb_ctrlrequest *req
                          , void *data);
+int usb_clear_halt(struct usb_pipe *defpipe, struct usb_pipe *pipe, int dir);
 void free_pipe(struct usb_pipe *pipe);
 struct usb_pipe *usb_getFreePipe(struct usb_s *cntl, u8 eptype);
 void usb_desc2pipe(struct usb_pipe *pipe, struct usbdevice_s *usbdev
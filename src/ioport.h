@@ -66,6 +66,7 @@
 #define SEROFF_IER     1
 #define SEROFF_DLH     1
 #define SEROFF_IIR     2
+#define SEROFF_FCR     2
 #define SEROFF_LCR     3
 #define SEROFF_LSR     5
 #define SEROFF_MSR     6
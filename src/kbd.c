@@ -48,9 +48,17 @@ kbd_init(void)
             , x + FIELD_SIZEOF(struct bios_data_area_s, kbd_buf));
 }
 
+// Scan code of the boot menu key while POST watches for it (see
+// bootmenu_start), and whether it has been pressed.
+u8 KeyLatchCode VARLOW;
+u8 KeyLatched VARLOW;
+
 static u8
 enqueue_key(u8 scan_code, u8 ascii_code)
 {
+    if (CONFIG_BOOTMENU && scan_code && scan_code == GET_LOW(KeyLatchCode))
+        SET_LOW(KeyLatched, 1);
+
     u16 buffer_start = GET_BDA(kbd_buf_start_offset);
     u16 buffer_end   = GET_BDA(kbd_buf_end_offset);
 
@@ -256,6 +264,9 @@ handle_16(struct bregs *regs)
     if (! CONFIG_KEYBOARD)
         return;
 
+    u8 func = regs->ah;
+    u32 start = callstats_start();
+
     // XXX - set_leds should be called from irq handler
     set_leds();
 
@@ -274,6 +285,11 @@ handle_16(struct bregs *regs)
     case 0x6f: handle_166f(regs); break;
     default:   handle_16XX(regs); break;
     }
+    if (func == 0x00 || func == 0x10)
+        // Blocking key reads - their time is spent waiting for the user.
+        callstats_count(CALLSTATS_16, func);
+    else
+        callstats_finish(CALLSTATS_16, func, start);
 }
 
 #define none 0
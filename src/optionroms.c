@@ -36,9 +36,11 @@ __callrom(struct rom_header *rom, u16 offset, u16 bdf)
     br.es = SEG_BIOS;
     br.di = get_pnp_offset();
     br.code = SEGOFF(seg, offset);
+    timeline_mark("optionrom %04x:%04x", seg, offset);
     start_preempt();
     farcall16big(&br);
     finish_preempt();
+    timeline_mark("optionrom %04x:%04x done", seg, offset);
 
     debug_serial_preinit();
 }
@@ -59,6 +61,13 @@ call_bcv(u16 seg, u16 ip)
 
 static int EnforceChecksum;
 
+// Skip roms not in the boot order once the first boot device is ready.
+static int
+skip_rom(int prio)
+{
+    return prio < 0 && boot_first_ready();
+}
+
 // Verify that an option rom looks valid
 static int
 is_valid_rom(struct rom_header *rom)
@@ -199,6 +208,10 @@ run_file_roms(const char *prefix, int isvga, u64 *sources)
         file = romfile_findprefix(prefix, file);
         if (!file)
             break;
+        if (!isvga && skip_rom(bootprio_find_named_rom(file->name, 0))) {
+            dprintf(1, "Skipping rom %s (not in boot order)\n", file->name);
+            continue;
+        }
         struct rom_header *rom = deploy_romfile(file);
         if (rom) {
             setRomSource(sources, rom, (u32)file);
@@ -230,9 +243,91 @@ is_pci_vga(struct pci_device *pci)
     return 1;
 }
 
+// Cache of pci rom images.  An image is identified by the device ids,
+// its size, and a hash of its first and last 512 bytes - only those are
+// read from the device, so a change elsewhere in the image does not
+// alter the hash.  The end of the image normally holds the rom checksum
+// byte.  Images are found in a copy of an earlier read of the same
+// image, or in a "romcache/pciVVVV,DDDD.rom" file.  A file must also end
+// with the device's checksum byte and its whole image must checksum to
+// zero.
+struct romcache_s {
+    struct romcache_s *next;
+    u16 vendor, device;
+    u32 size, hash;
+    void *data;
+};
+static struct romcache_s *RomCache;
+
+#define ROMCACHE_HASHLEN 512
+
+static u32
+romcache_hash(u8 *head, u8 *tail)
+{
+    u32 hash = 0;
+    int i;
+    for (i=0; i<ROMCACHE_HASHLEN; i++)
+        hash = hash * 31 + head[i];
+    for (i=0; i<ROMCACHE_HASHLEN; i++)
+        hash = hash * 31 + tail[i];
+    return hash;
+}
+
+static void
+romcache_add(struct pci_device *pci, u32 size, u32 hash, void *rom)
+{
+    struct romcache_s *rc = malloc_tmphigh(sizeof(*rc));
+    void *data = malloc_tmphigh(size);
+    if (!rc || !data) {
+        free(rc);
+        free(data);
+        return;
+    }
+    memcpy(data, rom, size);
+    rc->vendor = pci->vendor;
+    rc->device = pci->device;
+    rc->size = size;
+    rc->hash = hash;
+    rc->data = data;
+    rc->next = RomCache;
+    RomCache = rc;
+}
+
+// Fill 'newrom' from the cache - returns 0 on success.
+static int
+romcache_lookup(struct pci_device *pci, u32 size, u32 hash, u8 csum
+                , u8 *newrom)
+{
+    struct romcache_s *rc;
+    for (rc = RomCache; rc; rc = rc->next) {
+        if (rc->vendor == pci->vendor && rc->device == pci->device
+            && rc->size == size && rc->hash == hash) {
+            dprintf(4, "Copying cached option rom from %p\n", rc->data);
+            memcpy(newrom, rc->data, size);
+            return 0;
+        }
+    }
+
+    char fname[26];
+    snprintf(fname, sizeof(fname), "romcache/pci%04x,%04x.rom"
+             , pci->vendor, pci->device);
+    struct romfile_s *file = romfile_find(fname);
+    if (!file || file->size != size)
+        return -1;
+    int ret = file->copy(file, newrom, size);
+    if (ret != size || newrom[size - 1] != csum || checksum(newrom, size)
+        || romcache_hash(newrom, newrom + size - ROMCACHE_HASHLEN) != hash) {
+        dprintf(1, "Option rom file %s doesn't match device rom\n", fname);
+        return -1;
+    }
+    dprintf(4, "Copied option rom from %s\n", fname);
+    romcache_add(pci, size, hash, newrom);
+    return 0;
+}
+
 // Copy a rom to its permanent location below 1MiB
 static struct rom_header *
-copy_rom(struct rom_header *rom)
+copy_rom(struct pci_device *pci, struct rom_header *rom)
 {
     u32 romsize = rom->size * 512;
     struct rom_header *newrom = rom_reserve(romsize);
@@ -240,9 +335,18 @@ copy_rom(struct rom_header *rom)
         warn_noalloc();
         return NULL;
     }
+    u8 head[ROMCACHE_HASHLEN], tail[ROMCACHE_HASHLEN];
+    iomemcpy(head, rom, sizeof(head));
+    iomemcpy(tail, (void*)rom + romsize - sizeof(tail), sizeof(tail));
+    u32 hash = romcache_hash(head, tail);
+    if (!romcache_lookup(pci, romsize, hash, tail[sizeof(tail) - 1]
+                         , (void*)newrom))
+        return newrom;
+
     dprintf(4, "Copying option rom (size %d) from %p to %p\n"
             , romsize, rom, newrom);
     iomemcpy(newrom, rom, romsize);
+    romcache_add(pci, romsize, hash, newrom);
     return newrom;
 }
 
@@ -308,7 +412,7 @@ map_pcirom(struct pci_device *pci)
         rom = (void*)((u32)rom + pd->ilen * 512);
     }
 
-    rom = copy_rom(rom);
+    rom = copy_rom(pci, rom);
     pci_config_writel(bdf, PCI_ROM_ADDRESS, orig);
     return rom;
 fail:
@@ -367,6 +471,12 @@ optionrom_setup(void)
         foreachpci(pci) {
             if (pci->class == PCI_CLASS_DISPLAY_VGA || pci->have_driver)
                 continue;
+            if (skip_rom(bootprio_find_pci_device(pci))) {
+                dprintf(1, "Skipping rom of %02x:%02x.%x (not in boot order)\n"
+                        , pci_bdf_to_bus(pci->bdf), pci_bdf_to_dev(pci->bdf)
+                        , pci_bdf_to_fn(pci->bdf));
+                continue;
+            }
             init_pcirom(pci, 0, sources);
         }
 
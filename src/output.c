@@ -12,6 +12,7 @@
 #include "config.h" // CONFIG_*
 #include "biosvar.h" // GET_GLOBAL
 #include "fw/paravirt.h" // PlatformRunningOn
+#include "memmap.h" // add_e820
 
 struct putcinfo {
     void (*func)(struct putcinfo *info, char c);
@@ -26,6 +27,8 @@ struct putcinfo {
 
 u16 DebugOutputPort VARFSEG = 0x402;
 
+static void debug_serial_fifo(void);
+
 void
 debug_serial_preinit(void)
 {
@@ -43,6 +46,9 @@ debug_serial_preinit(void)
     if (oldparam != newparam || oldier != newier)
         dprintf(1, "Changing serial settings was %x/%x now %x/%x\n"
                 , oldparam, oldier, newparam, newier);
+
+    if (!MODESEGMENT)
+        debug_serial_fifo();
 }
 
 // Write a character to the serial port.
@@ -72,12 +78,241 @@ debug_serial_flush(void)
             return;
 }
 
+
+
+/****************************************************************
+ * Debug output buffering
+ ****************************************************************/
+
+#define DEBUG_BUFSIZE 4096
+#define DEBUG_FIFOSIZE 16
+
+// Ring buffer of debug output not yet sent to the debug port and
+// serial port (only used by 32bit code during POST).
+static char *DebugBuf;
+static u32 DebugHead, DebugPortTail, DebugSerialTail;
+static u8 DebugSerialCR, DebugSerialFifo = 1;
+
+// Check if debug output is currently being buffered.
+static int
+debug_buffered(void)
+{
+    return CONFIG_DEBUG_BUFFER && !MODESEGMENT && DebugBuf;
+}
+
+// Enable the serial port fifo so buffered output can be sent in bursts.
+static void
+debug_serial_fifo(void)
+{
+    if (!CONFIG_DEBUG_BUFFER || !CONFIG_DEBUG_SERIAL)
+        return;
+    DebugSerialFifo = 1;
+    if ((inb(CONFIG_DEBUG_SERIAL_PORT+SEROFF_IIR) & 0xc0) != 0xc0) {
+        debug_serial_flush();
+        outb(0x07, CONFIG_DEBUG_SERIAL_PORT+SEROFF_FCR);
+        if ((inb(CONFIG_DEBUG_SERIAL_PORT+SEROFF_IIR) & 0xc0) != 0xc0)
+            // No fifo (8250/16450) - send one character at a time.
+            return;
+    }
+    DebugSerialFifo = DEBUG_FIFOSIZE;
+}
+
+// Send all buffered output to the debug port.
+static void
+debug_buffer_port(void)
+{
+    if (!CONFIG_DEBUG_IO || !runningOnQEMU()) {
+        DebugPortTail = DebugHead;
+        return;
+    }
+    while (DebugPortTail != DebugHead) {
+        u32 pos = DebugPortTail % DEBUG_BUFSIZE;
+        u32 count = DebugHead - DebugPortTail;
+        if (count > DEBUG_BUFSIZE - pos)
+            count = DEBUG_BUFSIZE - pos;
+        outsb(GET_GLOBAL(DebugOutputPort), (u8*)&DebugBuf[pos], count);
+        DebugPortTail += count;
+    }
+}
+
+// Send buffered output to the serial port.  Characters are only
+// written when the transmitter is empty (and then up to a fifo full);
+// if 'wait' is set, poll for the transmitter once before giving up.
+static void
+debug_buffer_serial(int wait)
+{
+    if (!CONFIG_DEBUG_SERIAL) {
+        DebugSerialTail = DebugHead;
+        return;
+    }
+    while (DebugSerialTail != DebugHead) {
+        int timeout = DEBUG_TIMEOUT;
+        while ((inb(CONFIG_DEBUG_SERIAL_PORT+SEROFF_LSR) & 0x20) != 0x20) {
+            if (!wait)
+                return;
+            if (!timeout--)
+                break;
+        }
+        if (timeout < 0) {
+            // Ran out of time - drop a character.
+            DebugSerialCR = 0;
+            DebugSerialTail++;
+            return;
+        }
+        int space = DebugSerialFifo;
+        while (space-- && DebugSerialTail != DebugHead) {
+            char c = DebugBuf[DebugSerialTail % DEBUG_BUFSIZE];
+            if (c == '\n' && !DebugSerialCR) {
+                outb('\r', CONFIG_DEBUG_SERIAL_PORT+SEROFF_DATA);
+                DebugSerialCR = 1;
+                continue;
+            }
+            outb(c, CONFIG_DEBUG_SERIAL_PORT+SEROFF_DATA);
+            DebugSerialCR = 0;
+            DebugSerialTail++;
+        }
+        wait = 0;
+    }
+}
+
+// Return the number of characters not yet sent to all ports.
+static u32
+debug_buffer_pending(void)
+{
+    u32 port = DebugHead - DebugPortTail, serial = DebugHead - DebugSerialTail;
+    return port > serial ? port : serial;
+}
+
+// Add a character to the buffer - waits for the ports if it is full.
+static void
+debug_buffer_putc(char c)
+{
+    while (debug_buffer_pending() >= DEBUG_BUFSIZE) {
+        debug_buffer_port();
+        debug_buffer_serial(1);
+    }
+    DebugBuf[DebugHead++ % DEBUG_BUFSIZE] = c;
+}
+
+// Send whatever buffered output the ports accept without waiting.
+// Called while waiting on hardware.
+void
+debug_drain(void)
+{
+    if (!debug_buffered())
+        return;
+    debug_buffer_port();
+    debug_buffer_serial(0);
+}
+
+// Send all buffered output.
+void
+debug_flush(void)
+{
+    if (!debug_buffered())
+        return;
+    while (debug_buffer_pending()) {
+        debug_buffer_port();
+        debug_buffer_serial(1);
+    }
+}
+
+// Start buffering debug output from 32bit code.
+void
+debug_buffer_setup(void)
+{
+    if (!CONFIG_DEBUG_BUFFER)
+        return;
+    char *buf = malloc_tmphigh(DEBUG_BUFSIZE);
+    if (!buf) {
+        warn_noalloc();
+        return;
+    }
+    DebugHead = DebugPortTail = DebugSerialTail = DebugSerialCR = 0;
+    DebugBuf = buf;
+}
+
+// Stop buffering before boot (the buffer is in temporary memory).
+void
+debug_prepboot(void)
+{
+    debug_flush();
+    DebugBuf = NULL;
+}
+
+
+
+/****************************************************************
+ * Boot log
+ ****************************************************************/
+
+// Copy of the debug output kept in reserved memory for the OS - the
+// layout matches the coreboot cbmem console.
+struct debuglog_s {
+    u32 size;
+    u32 cursor;
+    char body[0];
+} PACKED;
+
+static struct debuglog_s *DebugLog;
+// Set while showing a message above CONFIG_DEBUG_LOG_LEVEL.
+static int DebugLogMute;
+
+static void
+debug_log_putc(struct debuglog_s *log, char c)
+{
+    if (log->cursor < log->size)
+        log->body[log->cursor++] = c;
+}
+
+// Write a zero padded decimal number to the log.
+static void
+debug_log_dec(struct debuglog_s *log, u32 val, int width)
+{
+    char buf[10], *p = &buf[sizeof(buf)];
+    do {
+        *--p = '0' + val % 10;
+        val /= 10;
+    } while (val || --width > 0);
+    while (p < &buf[sizeof(buf)])
+        debug_log_putc(log, *p++);
+}
+
+// Write a character to the log - lines start with a "[sec.usec]"
+// timestamp.
+static void
+debug_log(char c)
+{
+    if (!CONFIG_DEBUG_LOG || MODESEGMENT)
+        return;
+    struct debuglog_s *log = DebugLog;
+    if (!log || DebugLogMute)
+        return;
+    if (!log->cursor || log->body[log->cursor-1] == '\n') {
+        u32 usec = timer_read_usec();
+        debug_log_putc(log, '[');
+        debug_log_dec(log, usec / 1000000, 1);
+        debug_log_putc(log, '.');
+        debug_log_dec(log, usec % 1000000, 6);
+        debug_log_putc(log, ']');
+        debug_log_putc(log, ' ');
+    }
+    debug_log_putc(log, c);
+}
+
 // Write a character to debug port(s).
 static void
 putc_debug(struct putcinfo *action, char c)
 {
     if (! CONFIG_DEBUG_LEVEL)
         return;
+    if (!MODESEGMENT)
+        debug_log(c);
+    if (debug_buffered()) {
+        debug_cbmem(c);
+        debug_buffer_putc(c);
+        return;
+    }
     if (CONFIG_DEBUG_IO && runningOnQEMU())
         // Send character to debug port.
         outb(c, GET_GLOBAL(DebugOutputPort));
@@ -343,6 +578,7 @@ panic(const char *fmt, ...)
         va_start(args, fmt);
         bvprintf(&debuginfo, fmt, args);
         va_end(args);
+        debug_flush();
         debug_serial_flush();
     }
 
@@ -352,8 +588,8 @@ panic(const char *fmt, ...)
         hlt();
 }
 
-void
-__dprintf(const char *fmt, ...)
+static void
+debug_vprintf(const char *fmt, va_list args)
 {
     if (!MODESEGMENT && CONFIG_THREADS && CONFIG_DEBUG_LEVEL >= DEBUG_thread
         && *fmt != '\\' && *fmt != '/') {
@@ -367,11 +603,32 @@ __dprintf(const char *fmt, ...)
         }
     }
 
+    bvprintf(&debuginfo, fmt, args);
+    if (!debug_buffered())
+        debug_serial_flush();
+}
+
+void
+__dprintf(const char *fmt, ...)
+{
     va_list args;
     va_start(args, fmt);
-    bvprintf(&debuginfo, fmt, args);
+    debug_vprintf(fmt, args);
     va_end(args);
-    debug_serial_flush();
+}
+
+// Show a debug message that is not kept in the boot log.
+void
+__dprintf_nolog(const char *fmt, ...)
+{
+    if (!MODESEGMENT)
+        DebugLogMute = 1;
+    va_list args;
+    va_start(args, fmt);
+    debug_vprintf(fmt, args);
+    va_end(args);
+    if (!MODESEGMENT)
+        DebugLogMute = 0;
 }
 
 void
@@ -452,6 +709,176 @@ znprintf(size_t size, const char *fmt, ...)
 }
 
 
+/****************************************************************
+ * POST timeline
+ ****************************************************************/
+
+#define TIMELINE_SIZE (2*PAGE_SIZE)
+// Entries only used by timeline_phase() - so the POST phases up to
+// startBoot are recorded even when threads fill the table.
+#define TIMELINE_PHASE_SLOTS 16
+
+struct timeline_entry_s {
+    u64 tsc;
+    u32 usec;
+    u32 reserved;
+    char name[32];
+} PACKED;
+
+// Table of timestamped POST events kept in reserved memory for the
+// OS.  The 'usec' fields are filled in by timeline_report().
+struct timeline_s {
+    u32 count;
+    u32 max;
+    u32 dropped;        // Events that did not fit in the table
+    u32 reserved;
+    struct timeline_entry_s entries[0];
+} PACKED;
+
+static struct timeline_s *Timeline;
+
+static void
+timeline_add(u32 slots, const char *fmt, va_list args)
+{
+    struct timeline_s *tl = Timeline;
+    if (!tl)
+        return;
+    if (tl->count >= tl->max - slots) {
+        tl->dropped++;
+        return;
+    }
+    struct timeline_entry_s *e = &tl->entries[tl->count++];
+    e->tsc = rdtscll();
+    struct snprintfinfo sinfo = { { putc_str }, e->name
+                                  , e->name + sizeof(e->name) - 1 };
+    bvprintf(&sinfo.info, fmt, args);
+    *sinfo.str = '\0';
+}
+
+// Record an event (thread, option rom, device setup) in the timeline.
+void
+timeline_mark(const char *fmt, ...)
+{
+    if (!CONFIG_DEBUG_TIMELINE || MODESEGMENT)
+        return;
+    va_list args;
+    va_start(args, fmt);
+    timeline_add(TIMELINE_PHASE_SLOTS, fmt, args);
+    va_end(args);
+}
+
+// Record the start of a POST phase in the timeline.
+void
+timeline_phase(const char *fmt, ...)
+{
+    if (!CONFIG_DEBUG_TIMELINE || MODESEGMENT)
+        return;
+    va_list args;
+    va_start(args, fmt);
+    timeline_add(0, fmt, args);
+    va_end(args);
+}
+
+// Convert the timeline to microseconds and show it.
+void
+timeline_report(void)
+{
+    if (!CONFIG_DEBUG_TIMELINE)
+        return;
+    struct timeline_s *tl = Timeline;
+    if (!tl)
+        return;
+    dprintf(1, "POST timeline (usec since cpu reset):\n");
+    int i;
+    u32 last = 0;
+    for (i=0; i<tl->count; i++) {
+        struct timeline_entry_s *e = &tl->entries[i];
+        e->usec = timer_tsc_to_usec(e->tsc);
+        dprintf(1, "  %u (+%u) %s\n", e->usec, i ? e->usec - last : 0, e->name);
+        last = e->usec;
+    }
+    if (tl->dropped)
+        dprintf(1, "  (%u events not recorded - timeline full)\n", tl->dropped);
+}
+
+
+/****************************************************************
+ * Boot log and timeline setup
+ ****************************************************************/
+
+// Anchor (on a 16 byte boundary in the f-segment) that locates the
+// boot log and the POST timeline.
+struct debuglog_anchor_s {
+    u32 signature;
+    u8 length;
+    u8 checksum;
+    u8 version;
+    u8 level;
+    u32 log;
+    u32 timeline;
+} PACKED;
+
+#define DEBUGLOG_SIGNATURE 0x474f4c24 // $LOG
+
+// Allocate reserved memory for the OS visible debug tables.
+static void *
+debug_table_alloc(u32 size)
+{
+    void *table = memalign_tmphigh(PAGE_SIZE, size);
+    if (!table) {
+        warn_noalloc();
+        return NULL;
+    }
+    add_e820((u32)table, size, E820_RESERVED);
+    memset(table, 0, size);
+    return table;
+}
+
+// Allocate the boot log, the POST timeline, and their anchor.
+void
+debug_log_setup(void)
+{
+    if (!CONFIG_DEBUG_LOG && !CONFIG_DEBUG_TIMELINE)
+        return;
+    struct debuglog_anchor_s *anchor = malloc_fseg(sizeof(*anchor));
+    if (!anchor) {
+        warn_noalloc();
+        return;
+    }
+    memset(anchor, 0, sizeof(*anchor));
+    anchor->signature = DEBUGLOG_SIGNATURE;
+    anchor->length = sizeof(*anchor);
+    anchor->version = 2;
+    anchor->level = DEBUG_LOG_LEVEL;
+
+    if (CONFIG_DEBUG_LOG) {
+        struct debuglog_s *log = debug_table_alloc(CONFIG_DEBUG_LOG_SIZE);
+        if (log) {
+            log->size = CONFIG_DEBUG_LOG_SIZE - sizeof(*log);
+            anchor->log = (u32)log;
+            DebugLog = log;
+        }
+    }
+
+    u32 eax, ebx, ecx, edx, cpuid_features = 0;
+    cpuid(0, &eax, &ebx, &ecx, &edx);
+    if (eax > 0)
+        cpuid(1, &eax, &ebx, &ecx, &cpuid_features);
+    if (CONFIG_DEBUG_TIMELINE && cpuid_features & CPUID_TSC) {
+        struct timeline_s *tl = debug_table_alloc(TIMELINE_SIZE);
+        if (tl) {
+            tl->max = (TIMELINE_SIZE - sizeof(*tl)) / sizeof(tl->entries[0]);
+            anchor->timeline = (u32)tl;
+            Timeline = tl;
+        }
+    }
+
+    anchor->checksum -= checksum(anchor, sizeof(*anchor));
+    dprintf(1, "Boot log at %p, timeline at %p\n"
+            , (void*)anchor->log, (void*)anchor->timeline);
+}
+
+
 /****************************************************************
  * Misc helpers
  ****************************************************************/
@@ -296,6 +296,19 @@ pmm_getspace(struct zone_s *zone)
     return maxspace - reserve;
 }
 
+// Check if an area is unused space in ZoneTmpHigh.
+int
+malloc_tmphigh_unused(void *data, u32 size)
+{
+    struct allocinfo_s *info;
+    hlist_for_each_entry(info, &ZoneTmpHigh.head, node) {
+        if (data >= info->dataend && data <= info->allocend
+            && size <= info->allocend - data)
+            return 1;
+    }
+    return 0;
+}
+
 // Find the data block allocated with pmm_malloc with a given handle.
 static void *
 pmm_find(u32 handle)
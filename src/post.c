@@ -110,10 +110,13 @@ interface_init(void)
 {
     // Running at new code address - do code relocation fixups
     malloc_init();
+    debug_log_setup();
+    debug_buffer_setup();
 
     // Setup romfile items.
     qemu_cfg_init();
     coreboot_cbfs_init();
+    romfile_index_setup();
 
     // Setup ivt/bda/ebda
     ivt_init();
@@ -124,29 +127,85 @@ interface_init(void)
     bios32_init();
     pmm_init();
     pnp_init();
+    callstats_setup();
     kbd_init();
     mouse_init();
 }
 
+// Device setup steps - each runs in its own thread once the steps in
+// its 'deps' mask have returned.  (Without threads they run in order.)
+struct devinit_s {
+    const char *name;
+    void (*setup)(void);
+    u32 deps;
+};
+
+enum {
+    DI_USB, DI_PS2PORT, DI_LPT, DI_SERIAL, DI_FLOPPY, DI_ATA, DI_AHCI,
+    DI_CBFS_PAYLOAD, DI_RAMDISK, DI_VIRTIO_BLK, DI_VIRTIO_SCSI, DI_LSI_SCSI,
+    DI_ESP_SCSI, DI_MEGASAS, DI_COUNT
+};
+
+static struct devinit_s DeviceInit[DI_COUNT] = {
+    [DI_USB] = { "usb_setup", usb_setup },
+    // The usb controllers must be taken from the legacy emulation
+    // (done synchronously in usb_setup) before probing the ps2 port.
+    [DI_PS2PORT] = { "ps2port_setup", ps2port_setup, 1 << DI_USB },
+    [DI_LPT] = { "lpt_setup", lpt_setup },
+    [DI_SERIAL] = { "serial_setup", serial_setup },
+    [DI_FLOPPY] = { "floppy_setup", floppy_setup },
+    [DI_ATA] = { "ata_setup", ata_setup },
+    [DI_AHCI] = { "ahci_setup", ahci_setup },
+    [DI_CBFS_PAYLOAD] = { "cbfs_payload_setup", cbfs_payload_setup },
+    // Keep real floppy drives ahead of ram disks.
+    [DI_RAMDISK] = { "ramdisk_setup", ramdisk_setup, 1 << DI_FLOPPY },
+    [DI_VIRTIO_BLK] = { "virtio_blk_setup", virtio_blk_setup },
+    [DI_VIRTIO_SCSI] = { "virtio_scsi_setup", virtio_scsi_setup },
+    [DI_LSI_SCSI] = { "lsi_scsi_setup", lsi_scsi_setup },
+    [DI_ESP_SCSI] = { "esp_scsi_setup", esp_scsi_setup },
+    [DI_MEGASAS] = { "megasas_setup", megasas_setup },
+};
+
+static u32 DeviceInitDone;
+
+static void
+devinit_thread(void *data)
+{
+    struct devinit_s *di = data;
+    timeline_mark("%s", di->name);
+    di->setup();
+    timeline_mark("%s done", di->name);
+    DeviceInitDone |= 1 << (di - DeviceInit);
+}
+
+// Wait for the given device setup steps to return (their probe
+// threads may still be running).
+static void
+device_hardware_wait(u32 mask)
+{
+    while (mask & ~DeviceInitDone)
+        yield();
+}
+
 // Initialize hardware devices
 void
 device_hardware_setup(void)
 {
-    usb_setup();
-    ps2port_setup();
-    lpt_setup();
-    serial_setup();
-
-    floppy_setup();
-    ata_setup();
-    ahci_setup();
-    cbfs_payload_setup();
-    ramdisk_setup();
-    virtio_blk_setup();
-    virtio_scsi_setup();
-    lsi_scsi_setup();
-    esp_scsi_setup();
-    megasas_setup();
+    u32 started = 0;
+    DeviceInitDone = 0;
+    for (;;) {
+        int i;
+        for (i=0; i<DI_COUNT; i++) {
+            struct devinit_s *di = &DeviceInit[i];
+            if (started & (1 << i) || di->deps & ~DeviceInitDone)
+                continue;
+            started |= 1 << i;
+            run_thread(devinit_thread, di);
+        }
+        if (started == (1 << DI_COUNT) - 1)
+            break;
+        yield();
+    }
 }
 
 static void
@@ -177,7 +236,10 @@ prepareboot(void)
 
     // Finalize data structures before boot
     cdrom_prepboot();
+    floppy_prepboot();
     pmm_prepboot();
+    debug_prepboot();
+    cbfs_payload_prepboot();
     malloc_prepboot();
     memmap_prepboot();
 
@@ -192,6 +254,9 @@ startBoot(void)
     // Clear low-memory allocations (required by PMM spec).
     memset((void*)BUILD_STACK_ADDR, 0, BUILD_EBDA_MINIMUM - BUILD_STACK_ADDR);
 
+    timeline_phase("startBoot");
+    timeline_report();
+
     dprintf(3, "Jump to int19\n");
     struct bregs br;
     memset(&br, 0, sizeof(br));
@@ -205,8 +270,10 @@ maininit(void)
 {
     // Initialize internal interfaces.
     interface_init();
+    timeline_phase("interface_init done");
 
     // Setup platform devices.
+    timeline_phase("platform_hardware_setup");
     platform_hardware_setup();
 
     // Start hardware initialization (if optionrom threading)
@@ -214,6 +281,7 @@ maininit(void)
         device_hardware_setup();
 
     // Run vga option rom
+    timeline_phase("vgarom_setup");
     vgarom_setup();
 
     // Do hardware initialization (if running synchronously)
@@ -222,14 +290,23 @@ maininit(void)
         wait_threads();
     }
 
-    // Run option roms
+    // Run option roms - devices with a native driver are flagged by the
+    // pci scan of their setup step (probes need not have completed).
+    // Without threaded option roms all threads were waited for above,
+    // as they could not make progress while the option roms run.
+    if (CONFIG_THREAD_OPTIONROMS)
+        device_hardware_wait(1 << DI_ATA);
+    bootmenu_start();
+    timeline_phase("optionrom_setup");
     optionrom_setup();
 
     // Allow user to modify overall boot order.
+    timeline_phase("interactive_bootmenu");
     interactive_bootmenu();
     wait_threads();
 
     // Prepare for boot.
+    timeline_phase("prepareboot");
     prepareboot();
 
     // Write protect bios memory.
@@ -9,18 +9,158 @@
 
 static struct romfile_s *RomfileRoot VARVERIFY32INIT;
 
+// Lookup indexes built by romfile_index_setup().
+struct romfile_index_s {
+    struct romfile_s *file;
+    int pos; // Position of the file in the RomfileRoot list
+};
+static struct romfile_index_s *RomfileSorted VARVERIFY32INIT;
+static int RomfileCount VARVERIFY32INIT;
+static struct romfile_s **RomfileHash VARVERIFY32INIT;
+static u32 RomfileHashSize VARVERIFY32INIT;
+
+static void
+romfile_index_free(void)
+{
+    free(RomfileSorted);
+    free(RomfileHash);
+    RomfileSorted = NULL;
+    RomfileHash = NULL;
+    RomfileCount = RomfileHashSize = 0;
+}
+
 void
 romfile_add(struct romfile_s *file)
 {
     dprintf(3, "Add romfile: %s (size=%d)\n", file->name, file->size);
     file->next = RomfileRoot;
     RomfileRoot = file;
+    if (RomfileHash)
+        // Fall back to walking the list.
+        romfile_index_free();
+}
+
+static u32
+romfile_hash(const char *name)
+{
+    u32 hash = 0;
+    while (*name)
+        hash = hash * 31 + (u8)*name++;
+    return hash;
+}
+
+// Compare two names (using the same byte ordering as memcmp).
+static int
+romfile_namecmp(const char *s1, const char *s2)
+{
+    for (;;) {
+        if (*s1 != *s2)
+            return (u8)*s1 < (u8)*s2 ? -1 : 1;
+        if (! *s1)
+            return 0;
+        s1++;
+        s2++;
+    }
+}
+
+// Build a hashed index of the file names and an index sorted by name.
+void
+romfile_index_setup(void)
+{
+    romfile_index_free();
+    int count = 0;
+    struct romfile_s *file;
+    for (file = RomfileRoot; file; file = file->next)
+        count++;
+    if (!count)
+        return;
+    u32 hashsize = 1;
+    while (hashsize < count * 2)
+        hashsize <<= 1;
+    struct romfile_index_s *sorted = malloc_tmp(count * sizeof(sorted[0]));
+    struct romfile_s **hash = malloc_tmp(hashsize * sizeof(hash[0]));
+    if (!sorted || !hash) {
+        warn_noalloc();
+        free(sorted);
+        free(hash);
+        return;
+    }
+    memset(hash, 0, hashsize * sizeof(hash[0]));
+
+    int pos = 0;
+    for (file = RomfileRoot; file; file = file->next, pos++) {
+        // Hash on the full name - the first file in the list wins.
+        u32 h = romfile_hash(file->name) & (hashsize - 1);
+        while (hash[h] && strcmp(hash[h]->name, file->name) != 0)
+            h = (h + 1) & (hashsize - 1);
+        if (!hash[h])
+            hash[h] = file;
+
+        // Insert into the sorted index.
+        int i = pos;
+        while (i && romfile_namecmp(sorted[i-1].file->name, file->name) > 0) {
+            sorted[i] = sorted[i-1];
+            i--;
+        }
+        sorted[i].file = file;
+        sorted[i].pos = pos;
+    }
+
+    RomfileSorted = sorted;
+    RomfileCount = count;
+    RomfileHash = hash;
+    RomfileHashSize = hashsize;
+    dprintf(3, "Indexed %d romfiles\n", count);
+}
+
+// Search the sorted index for the file after 'prev' (in list order)
+// that matches the given prefix.
+static struct romfile_s *
+romfile_index_findprefix(const char *prefix, int prefixlen
+                         , struct romfile_s *prev)
+{
+    // Find the first name that doesn't sort before the prefix.
+    int lo = 0, hi = RomfileCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (memcmp(RomfileSorted[mid].file->name, prefix, prefixlen) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // Matching names are adjacent in the index.
+    int prevpos = -1, i;
+    if (prev) {
+        for (i=lo; i<RomfileCount; i++) {
+            struct romfile_index_s *ri = &RomfileSorted[i];
+            if (memcmp(ri->file->name, prefix, prefixlen) != 0)
+                return NULL;
+            if (ri->file == prev) {
+                prevpos = ri->pos;
+                break;
+            }
+        }
+        if (i >= RomfileCount)
+            return NULL;
+    }
+    struct romfile_index_s *best = NULL;
+    for (i=lo; i<RomfileCount; i++) {
+        struct romfile_index_s *ri = &RomfileSorted[i];
+        if (memcmp(ri->file->name, prefix, prefixlen) != 0)
+            break;
+        if (ri->pos > prevpos && (!best || ri->pos < best->pos))
+            best = ri;
+    }
+    return best ? best->file : NULL;
 }
 
 // Search for the specified file.
 static struct romfile_s *
 __romfile_findprefix(const char *prefix, int prefixlen, struct romfile_s *prev)
 {
+    if (RomfileSorted)
+        return romfile_index_findprefix(prefix, prefixlen, prev);
     struct romfile_s *cur = RomfileRoot;
     if (prev)
         cur = prev->next;
@@ -41,7 +181,15 @@ romfile_findprefix(const char *prefix, struct romfile_s *prev)
 struct romfile_s *
 romfile_find(const char *name)
 {
-    return __romfile_findprefix(name, strlen(name) + 1, NULL);
+    if (!RomfileHash)
+        return __romfile_findprefix(name, strlen(name) + 1, NULL);
+    u32 h = romfile_hash(name) & (RomfileHashSize - 1);
+    for (;;) {
+        struct romfile_s *file = RomfileHash[h];
+        if (!file || strcmp(file->name, name) == 0)
+            return file;
+        h = (h + 1) & (RomfileHashSize - 1);
+    }
 }
 
 // Helper function to find, malloc_tmphigh, and copy a romfile.  This
@@ -210,6 +210,8 @@ farcall16(struct bregs *callregs)
         return;
     }
     extern void _cfunc16__farcall16(void);
+    // Keep debug output in order with any output from 16bit code.
+    debug_flush();
     call16((u32)callregs, _cfunc16__farcall16);
 }
 
@@ -217,6 +219,7 @@ inline void
 farcall16big(struct bregs *callregs)
 {
     extern void _cfunc16__farcall16(void);
+    debug_flush();
     call16big((u32)callregs, _cfunc16__farcall16);
 }
 
@@ -242,18 +245,25 @@ __call16_int(struct bregs *callregs, u16 offset)
 struct thread_info {
     void *stackpos;
     struct hlist_node node;
+    u32 waketime;
 };
 struct thread_info MainThread VARFSEG = {
     NULL, { &MainThread.node, &MainThread.node.next }
 };
 #define THREADSTACKSIZE 4096
 
+// Number of threads (other than the main thread) - runnable, sleeping,
+// or waiting.  Only runnable threads are on the MainThread list.
+int ThreadCount VARFSEG;
+
+// Sleeping threads ordered by wake up time.
+static struct hlist_head ThreadSleepers;
+
 // Check if any threads are running.
-static int
+int
 have_threads(void)
 {
-    return (CONFIG_THREADS
-            && GET_FLATPTR(MainThread.node.next) != &MainThread.node);
+    return CONFIG_THREADS && GET_GLOBAL(ThreadCount);
 }
 
 // Return the 'struct thread_info' for the currently running thread.
@@ -266,15 +276,10 @@ getCurThread(void)
     return (void*)ALIGN_DOWN(esp, THREADSTACKSIZE);
 }
 
-// Switch to next thread stack.
+// Switch from the 'cur' thread stack to the 'next' thread stack.
 static void
-switch_next(struct thread_info *cur)
+switch_to(struct thread_info *cur, struct thread_info *next)
 {
-    struct thread_info *next = container_of(
-        cur->node.next, struct thread_info, node);
-    if (cur == next)
-        // Nothing to do.
-        return;
     asm volatile(
         "  pushl $1f\n"                 // store return pc
         "  pushl %%ebp\n"               // backup %ebp
@@ -288,12 +293,56 @@ switch_next(struct thread_info *cur)
         : "ebx", "edx", "esi", "edi", "cc", "memory");
 }
 
+// Move sleeping threads that are due to run after 'cur'.
+static void
+wake_sleepers(struct thread_info *cur)
+{
+    if (hlist_empty(&ThreadSleepers))
+        return;
+    u32 now = timer_calc(0);
+    struct hlist_node *n;
+    while ((n = ThreadSleepers.first)) {
+        struct thread_info *t = container_of(n, struct thread_info, node);
+        if ((s32)(now - t->waketime) <= 0)
+            break;
+        hlist_del(n);
+        hlist_add_after(n, &cur->node);
+    }
+}
+
+// Switch to next thread stack.
+static void
+switch_next(struct thread_info *cur)
+{
+    wake_sleepers(cur);
+    struct thread_info *next = container_of(
+        cur->node.next, struct thread_info, node);
+    if (cur == next)
+        // Nothing to do.
+        return;
+    switch_to(cur, next);
+}
+
+// Take the (non-main) thread 'cur' off the run list, add it to
+// 'pprev', and switch to the next runnable thread.
+static void
+switch_away(struct thread_info *cur, struct hlist_node **pprev)
+{
+    struct thread_info *next = container_of(
+        cur->node.next, struct thread_info, node);
+    hlist_del(&cur->node);
+    hlist_add(&cur->node, pprev);
+    switch_to(cur, next);
+}
+
 // Last thing called from a thread (called on "next" stack).
 static void
 __end_thread(struct thread_info *old)
 {
     hlist_del(&old->node);
     free(old);
+    ThreadCount--;
+    timeline_mark("thread %08x done", (u32)old);
     dprintf(DEBUG_thread, "\\%08x/ End thread\n", (u32)old);
     if (!have_threads())
         dprintf(1, "All threads complete.\n");
@@ -314,7 +363,9 @@ run_thread(void (*func)(void*), void *data)
     thread->stackpos = (void*)thread + THREADSTACKSIZE;
     struct thread_info *cur = getCurThread();
     hlist_add_after(&thread->node, &cur->node);
+    ThreadCount++;
 
+    timeline_mark("thread %08x %p", (u32)thread, func);
     dprintf(DEBUG_thread, "/%08x\\ Start thread\n", (u32)thread);
     asm volatile(
         // Start thread
@@ -361,6 +412,7 @@ yield(void)
         stack_hop_back(0, 0, check_irqs);
         return;
     }
+    debug_drain();
     extern void _cfunc16_check_irqs(void);
     if (!CONFIG_THREADS) {
         call16big(0, _cfunc16_check_irqs);
@@ -407,6 +459,60 @@ wait_threads(void)
         yield();
 }
 
+// Sleep until the timer passes 'end'.  Other threads are taken off the
+// run list until they are due; the main thread (which must keep
+// servicing irqs) and 16bit code just yield.
+void
+yield_until(u32 end)
+{
+    if (MODESEGMENT || !CONFIG_THREADS) {
+        yield();
+        return;
+    }
+    struct thread_info *cur = getCurThread();
+    if (cur == &MainThread) {
+        yield();
+        return;
+    }
+    cur->waketime = end;
+    struct thread_info *t;
+    struct hlist_node **pprev;
+    hlist_for_each_entry_pprev(t, pprev, &ThreadSleepers, node) {
+        if ((s32)(end - t->waketime) < 0)
+            break;
+    }
+    switch_away(cur, pprev);
+}
+
+// Block until wake_threads() is called on 'queue'.  The main thread
+// just yields, so callers must recheck their condition on return.
+void
+wait_thread_queue(struct hlist_head *queue)
+{
+    ASSERT32FLAT();
+    struct thread_info *cur = getCurThread();
+    if (!CONFIG_THREADS || cur == &MainThread) {
+        yield();
+        return;
+    }
+    switch_away(cur, &queue->first);
+}
+
+// Make all threads blocked on 'queue' runnable.
+void
+wake_threads(struct hlist_head *queue)
+{
+    ASSERT32FLAT();
+    if (!CONFIG_THREADS)
+        return;
+    struct thread_info *cur = getCurThread();
+    struct hlist_node *n;
+    while ((n = queue->first)) {
+        hlist_del(n);
+        hlist_add_after(n, &cur->node);
+    }
+}
+
 void
 mutex_lock(struct mutex_s *mutex)
 {
@@ -414,7 +520,7 @@ mutex_lock(struct mutex_s *mutex)
     if (! CONFIG_THREADS)
         return;
     while (mutex->isLocked)
-        yield();
+        wait_thread_queue(&mutex->waiters);
     mutex->isLocked = 1;
 }
 
@@ -425,6 +531,7 @@ mutex_unlock(struct mutex_s *mutex)
     if (! CONFIG_THREADS)
         return;
     mutex->isLocked = 0;
+    wake_threads(&mutex->waiters);
 }
 
 
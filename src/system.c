@@ -339,6 +339,8 @@ void VISIBLE16
 handle_15(struct bregs *regs)
 {
     debug_enter(regs, DEBUG_HDL_15);
+    u8 func = regs->ah;
+    u32 start = callstats_start();
     switch (regs->ah) {
     case 0x24: handle_1524(regs); break;
     case 0x4f: handle_154f(regs); break;
@@ -355,7 +357,9 @@ handle_15(struct bregs *regs)
     case 0xc0: handle_15c0(regs); break;
     case 0xc1: handle_15c1(regs); break;
     case 0xc2: handle_15c2(regs); break;
+    case 0xd9: handle_15d9(regs); break;
     case 0xe8: handle_15e8(regs); break;
     default:   handle_15XX(regs); break;
     }
+    callstats_finish(CALLSTATS_15, func, start);
 }
@@ -7,6 +7,7 @@
 #define __UTIL_H
 
 #include "types.h" // u32
+#include "list.h" // hlist_head
 
 static inline void irq_disable(void)
 {
@@ -191,8 +192,12 @@ struct thread_info *getCurThread(void);
 void yield(void);
 void yield_toirq(void);
 void run_thread(void (*func)(void*), void *data);
+int have_threads(void);
 void wait_threads(void);
-struct mutex_s { u32 isLocked; };
+void yield_until(u32 end);
+void wait_thread_queue(struct hlist_head *queue);
+void wake_threads(struct hlist_head *queue);
+struct mutex_s { u32 isLocked; struct hlist_head waiters; };
 void mutex_lock(struct mutex_s *mutex);
 void mutex_unlock(struct mutex_s *mutex);
 void start_preempt(void);
@@ -203,6 +208,16 @@ void check_preempt(void);
 // output.c
 extern u16 DebugOutputPort;
 void debug_serial_preinit(void);
+void debug_drain(void);
+void debug_flush(void);
+void debug_buffer_setup(void);
+void debug_prepboot(void);
+void debug_log_setup(void);
+void timeline_mark(const char *fmt, ...)
+    __attribute__ ((format (printf, 1, 2)));
+void timeline_phase(const char *fmt, ...)
+    __attribute__ ((format (printf, 1, 2)));
+void timeline_report(void);
 void panic(const char *fmt, ...)
     __attribute__ ((format (printf, 1, 2))) __noreturn;
 void printf(const char *fmt, ...)
@@ -213,6 +228,8 @@ char * znprintf(size_t size, const char *fmt, ...)
     __attribute__ ((format (printf, 2, 3)));
 void __dprintf(const char *fmt, ...)
     __attribute__ ((format (printf, 1, 2)));
+void __dprintf_nolog(const char *fmt, ...)
+    __attribute__ ((format (printf, 1, 2)));
 void __debug_enter(struct bregs *regs, const char *fname);
 void __debug_isr(const char *fname);
 void __debug_stub(struct bregs *regs, int lineno, const char *fname);
@@ -229,8 +246,12 @@ void __set_code_unimplemented(struct bregs *regs, u32 linecode
 void hexdump(const void *d, int len);
 
 #define dprintf(lvl, fmt, args...) do {                         \
-        if (CONFIG_DEBUG_LEVEL && (lvl) <= CONFIG_DEBUG_LEVEL)  \
-            __dprintf((fmt) , ##args );                         \
+        if (CONFIG_DEBUG_LEVEL && (lvl) <= CONFIG_DEBUG_LEVEL) {\
+            if ((lvl) > DEBUG_LOG_LEVEL)                        \
+                __dprintf_nolog((fmt) , ##args );               \
+            else                                                \
+                __dprintf((fmt) , ##args );                     \
+        }                                                       \
     } while (0)
 #define debug_enter(regs, lvl) do {                     \
         if ((lvl) && (lvl) <= CONFIG_DEBUG_LEVEL)       \
@@ -262,6 +283,7 @@ void hexdump(const void *d, int len);
     __set_code_unimplemented((regs), (code) | (__LINE__ << 8), __func__)
 
 // kbd.c
+extern u8 KeyLatchCode, KeyLatched;
 void kbd_init(void);
 void handle_15c2(struct bregs *regs);
 void process_key(u8 key);
@@ -286,6 +308,9 @@ void timer_setup(void);
 void pmtimer_setup(u16 ioport);
 u32 timer_calc(u32 msecs);
 u32 timer_calc_usec(u32 usecs);
+u32 timer_elapsed_usec(u32 start);
+u32 timer_tsc_to_usec(u64 tsc);
+u32 timer_read_usec(void);
 int timer_check(u32 end);
 void ndelay(u32 count);
 void udelay(u32 count);
@@ -303,6 +328,19 @@ int irqtimer_check(u32 end);
 void apm_shutdown(void);
 void handle_1553(struct bregs *regs);
 
+// callstats.c
+#define CALLSTATS_13 0
+#define CALLSTATS_15 1
+#define CALLSTATS_16 2
+#define CALLSTATS_1a 3
+#define CALLSTATS_VECTORS 4
+#define CALLSTATS_BUCKETS 8
+void callstats_setup(void);
+u32 callstats_start(void);
+void callstats_count(int vector, u8 func);
+void callstats_finish(int vector, u8 func, u32 start);
+void handle_15d9(struct bregs *regs);
+
 // pcibios.c
 void handle_1ab1(struct bregs *regs);
 void bios32_init(void);
@@ -334,8 +372,16 @@ void debug_cbmem(char c);
 void cbfs_run_payload(struct cbfs_file *file);
 void coreboot_platform_setup(void);
 void cbfs_payload_setup(void);
+void cbfs_payload_prepboot(void);
 void coreboot_preinit(void);
 void coreboot_cbfs_init(void);
+#define LZMA_SCRATCH_SIZE 15980
+int ulzma_scratch(u8 *dst, u32 maxlen, const u8 *src, u32 srclen
+                  , void *scratch, u32 scratchlen);
+
+// fw/lz4.c
+int ulz4_size(const u8 *src, u32 srclen);
+int ulz4(u8 *dst, u32 maxlen, const u8 *src, u32 srclen);
 
 // fw/biostable.c
 void copy_smbios(void *pos);
@@ -380,6 +426,7 @@ void malloc_preinit(void);
 extern u32 LegacyRamSize;
 void malloc_init(void);
 void malloc_prepboot(void);
+int malloc_tmphigh_unused(void *data, u32 size);
 void *pmm_malloc(struct zone_s *zone, u32 handle, u32 size, u32 align);
 int pmm_free(void *data);
 void pmm_init(void);
@@ -442,6 +489,7 @@ struct romfile_s {
     int (*copy)(struct romfile_s *file, void *dest, u32 maxlen);
 };
 void romfile_add(struct romfile_s *file);
+void romfile_index_setup(void);
 struct romfile_s *romfile_findprefix(const char *prefix, struct romfile_s *prev);
 struct romfile_s *romfile_find(const char *name);
 void *romfile_loadfile(const char *name, int *psize);